@@ -0,0 +1,105 @@
+//File: boundedQueue.h
+//Brief: A fixed-capacity, lock-free, multi-producer multi-consumer queue.
+//       Used to hand batches between pipeline<> stages without any thread
+//       ever holding a lock.
+//Author: Andrew Olivier aolivier@ur.rochester.edu
+
+//This is Dmitry Vyukov's bounded MPMC queue: http://www.1024cores.net/home/lock-free-algorithms/queues/bounded-mpmc-queue
+//Each cell carries a sequence number that tells producers and consumers whose turn it is to use that cell.
+//push() and pop() never block.  They return false instead when the queue is full or empty.
+//
+//T must be default constructible and move assignable because every cell holds a T for the lifetime of the queue.
+
+#ifndef UNITS_BOUNDEDQUEUE_H
+#define UNITS_BOUNDEDQUEUE_H
+
+//c++ includes
+#include <atomic>
+#include <memory>
+#include <cstddef>
+
+namespace units
+{
+  template <class T>
+  class boundedQueue
+  {
+    public:
+      //capacity is rounded up to a power of 2 so that wrapping around is just a mask.
+      explicit boundedQueue(const size_t capacity): fMask(roundUp(capacity) - 1), fCells(new cell[fMask + 1]), fEnqueuePos(0), fDequeuePos(0)
+      {
+        for(size_t pos = 0; pos <= fMask; ++pos) fCells[pos].sequence.store(pos, std::memory_order_relaxed);
+      }
+
+      boundedQueue(const boundedQueue&) = delete;
+      boundedQueue& operator =(const boundedQueue&) = delete;
+
+      size_t capacity() const { return fMask + 1; }
+
+      bool push(T&& value)
+      {
+        size_t pos = fEnqueuePos.load(std::memory_order_relaxed);
+        cell* target;
+        while(true)
+        {
+          target = &fCells[pos & fMask];
+          const size_t seq = target->sequence.load(std::memory_order_acquire);
+          const auto diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos);
+          if(diff == 0)
+          {
+            if(fEnqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+          }
+          else if(diff < 0) return false; //full
+          else pos = fEnqueuePos.load(std::memory_order_relaxed);
+        }
+
+        target->data = std::move(value);
+        target->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+      }
+
+      bool pop(T& value)
+      {
+        size_t pos = fDequeuePos.load(std::memory_order_relaxed);
+        cell* target;
+        while(true)
+        {
+          target = &fCells[pos & fMask];
+          const size_t seq = target->sequence.load(std::memory_order_acquire);
+          const auto diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos + 1);
+          if(diff == 0)
+          {
+            if(fDequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+          }
+          else if(diff < 0) return false; //empty
+          else pos = fDequeuePos.load(std::memory_order_relaxed);
+        }
+
+        value = std::move(target->data);
+        target->sequence.store(pos + fMask + 1, std::memory_order_release);
+        return true;
+      }
+
+    private:
+      struct cell
+      {
+        std::atomic<size_t> sequence;
+        T data;
+      };
+
+      static size_t roundUp(const size_t capacity)
+      {
+        size_t result = 2;
+        while(result < capacity) result *= 2;
+        return result;
+      }
+
+      const size_t fMask;
+      std::unique_ptr<cell[]> fCells;
+
+      //Keep producers and consumers from fighting over the same cache line
+      alignas(64) std::atomic<size_t> fEnqueuePos;
+      alignas(64) std::atomic<size_t> fDequeuePos;
+  };
+}
+
+#endif //UNITS_BOUNDEDQUEUE_H
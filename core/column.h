@@ -0,0 +1,90 @@
+//File: column.h
+//Brief: A column<> is a contiguous array of quantity<>s that all share
+//       the same units.  Columns are the structure-of-arrays building
+//       block for batches of events: the compiler still checks the units,
+//       but the numbers are laid out like a plain FLOATING_POINT array so
+//       that loops over them can be vectorized.
+//Author: Andrew Olivier aolivier@ur.rochester.edu
+
+//A column<> stores its values in the units of its own quantity<>, just like quantity<> stores fValue in
+//PREFIX units.  So, column<GeV> holds numbers in GeV, and converting a column<GeV> into a column<MeV> does
+//one multiplication per entry.  Columns with different BASE_TAGs never convert into each other.
+//
+//data() is the column<> version of a TTree branch address: it lets an external library read or write the
+//raw numbers directly.  At that point, you are asserting that you got the units right just like at any other
+//entry point.
+
+#ifndef UNITS_COLUMN_H
+#define UNITS_COLUMN_H
+
+//c++ includes
+#include <vector>
+#include <cstddef>
+
+namespace units
+{
+  namespace detail
+  {
+    //How many rows algorithms on column<>s work on at once.  Their innermost loops run over this many rows
+    //so that the compiler can vectorize them.
+    constexpr size_t batchLanes = 8;
+  }
+
+  //column<> is specialized for quantity<>s here and for matrices in covariance.h.
+  template <class QUANTITY>
+  class column;
+
+  template <class BASE_TAG, class PREFIX, class FLOATING_POINT>
+  class column<quantity<BASE_TAG, PREFIX, FLOATING_POINT>>
+  {
+    public:
+      //typedefs to help out other templates
+      using value_type = quantity<BASE_TAG, PREFIX, FLOATING_POINT>;
+      using tag = BASE_TAG;
+      using prefix = PREFIX;
+      using floating_point = FLOATING_POINT;
+
+      column() = default;
+
+      explicit column(const size_t size, const value_type init = value_type(0)): fValues(size, init.template in<value_type>()) {}
+
+      //Convert a column<> related to BASE_TAG by a ratio<>.  The conversion factor is a compile-time constant,
+      //so this is a single loop the compiler can vectorize.
+      template <class OTHER_PREFIX>
+      column(const column<quantity<BASE_TAG, OTHER_PREFIX, FLOATING_POINT>>& other): fValues(other.data(), other.data() + other.size())
+      {
+        for(auto& value: fValues) value = detail::conversion<std::ratio_divide<OTHER_PREFIX, PREFIX>, FLOATING_POINT>::do_convert(value);
+      }
+
+      //Element access.  Elements are returned by value because they are stored as FLOATING_POINTs.
+      value_type operator [](const size_t index) const
+      {
+        return value_type(fValues[index]);
+      }
+
+      void set(const size_t index, const value_type value)
+      {
+        fValues[index] = value.template in<value_type>();
+      }
+
+      void push_back(const value_type value)
+      {
+        fValues.push_back(value.template in<value_type>());
+      }
+
+      size_t size() const { return fValues.size(); }
+      bool empty() const { return fValues.empty(); }
+      void reserve(const size_t size) { fValues.reserve(size); }
+      void resize(const size_t size, const value_type init = value_type(0)) { fValues.resize(size, init.template in<value_type>()); }
+      void clear() { fValues.clear(); }
+
+      //Raw storage in this column<>'s units.  Entry and exit point for external libraries.
+      FLOATING_POINT* data() { return fValues.data(); }
+      const FLOATING_POINT* data() const { return fValues.data(); }
+
+    private:
+      std::vector<FLOATING_POINT> fValues;
+  };
+}
+
+#endif //UNITS_COLUMN_H
@@ -0,0 +1,549 @@
+//File: covariance.h
+//Brief: Covariance matrices whose elements have mixed units, like the
+//       cm^2, cm * MeV, and MeV^2 entries of a track fit.  Element (i, j)
+//       of a covMatrix<> is a quantity<> in units of UNITS_i * UNITS_j, so
+//       the compiler checks every entry you put in or take out.
+//Author: Andrew Olivier aolivier@ur.rochester.edu
+
+//Four matrix types live in this file:
+//*) covMatrix<UNITS...>: A symmetric covariance matrix.  Element (i, j) has the units of UNITS_i * UNITS_j.
+//*) weightMatrix<UNITS...>: The inverse of a covMatrix<>.  Element (i, j) has the units of 1 / (UNITS_i * UNITS_j).
+//*) choleskyFactor<UNITS...>: Lower-triangular L such that L * L^T is a covMatrix<>.  Every element of row i has
+//   the units of UNITS_i.
+//*) jacobian<std::tuple<TO...>, std::tuple<FROM...>>: Derivatives of one set of parameters with respect to another.
+//   Element (a, i) has the units of TO_a / FROM_i.
+//
+//Symmetric matrices are stored packed: only the lower triangle, row by row, in N * (N + 1) / 2 numbers.  Every
+//number is stored in the prefix of its own element's units, like quantity<> does.  Those prefixes always cancel
+//in the matrix algebra below, so similarity(), cholesky(), and inverse() never convert anything.
+//
+//J(a, i) * C(i, j) * J(b, j) is only in the units of C'(a, b) once units cancel (see the Nota Bene in
+//derivedUnits.h), so the algebra here works on the underlying numbers.
+//
+//Elements are read and written with get<ROW, COL>() and set<ROW, COL>().  A symmetric matrix answers to both
+//(i, j) and (j, i), but their types list the units in opposite orders: get<0, 1>() of a covMatrix<cm, MeV> is in
+//cm * MeV and get<1, 0>() is in MeV * cm.
+//
+//A column<> of any of these matrices stores many tracks as structure-of-arrays: one contiguous array per element.
+//similarity(), cholesky(), and inverse() on column<>s work on several tracks at a time in the innermost loop so that the
+//compiler can vectorize them.
+//
+//Example:
+//
+//units::covMatrix<cm, MeV> cov;
+//cov.set<0, 0>(0.04_cm * 1_cm);
+//cov.set<0, 1>(0.01_cm * 1_MeV);
+//cov.set<1, 1>(2.25_MeV * 1_MeV);
+//const auto weights = units::inverse(cov); //weightMatrix<cm, MeV>
+//std::cout << weights.get<0, 0>() << "\n"; //Prints something in 1 / (cm * cm)
+
+#ifndef UNITS_COVARIANCE_H
+#define UNITS_COVARIANCE_H
+
+//units includes
+#include "units.h"
+
+//c++ includes
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <tuple>
+#include <utility>
+#include <type_traits>
+
+namespace units
+{
+  namespace detail
+  {
+    //Layout of a packed symmetric matrix: the lower triangle, row by row.
+    constexpr size_t packedSize(const size_t dimension)
+    {
+      return dimension * (dimension + 1) / 2;
+    }
+
+    constexpr size_t packedIndex(const size_t row, const size_t col)
+    {
+      return (row >= col)?row * (row + 1) / 2 + col:col * (col + 1) / 2 + row;
+    }
+
+    constexpr size_t packedRow(const size_t index)
+    {
+      size_t row = 0;
+      while(packedSize(row + 1) <= index) ++row;
+      return row;
+    }
+
+    constexpr size_t packedCol(const size_t index)
+    {
+      return index - packedSize(packedRow(index));
+    }
+
+    //Types of matrix elements
+    template <class LHS, class RHS>
+    using productOf = decltype(std::declval<LHS>() * std::declval<RHS>());
+
+    template <class LHS, class RHS>
+    using ratioOf = decltype(std::declval<LHS>() / std::declval<RHS>());
+
+    template <class QUANTITY>
+    using inverseOf = quantity<typename buildRatio<productTag<>, typename QUANTITY::tag>::result,
+                               std::ratio_divide<std::ratio<1>, typename QUANTITY::prefix>, typename QUANTITY::floating_point>;
+
+    template <size_t INDEX, class ...UNITS>
+    using nth = typename std::tuple_element<INDEX, std::tuple<UNITS...>>::type;
+
+    //All of a matrix's units have to share a FLOATING_POINT
+    template <class ...UNITS>
+    struct commonFloat
+    {
+      using type = typename nth<0, UNITS...>::floating_point;
+      static_assert(std::is_same<std::tuple<type, typename UNITS::floating_point...>, std::tuple<typename UNITS::floating_point..., type>>::value,
+                    "All units in a matrix must use the same floating point type!");
+    };
+
+    //Storage shared by all matrix types.  data(element) is where element's number lives.
+    template <class FLOATING_POINT, size_t SIZE>
+    class matrixStorage
+    {
+      public:
+        using floating_point = FLOATING_POINT;
+        static constexpr size_t nElements = SIZE;
+
+        FLOATING_POINT* data(const size_t element = 0) { return fValues.data() + element; }
+        const FLOATING_POINT* data(const size_t element = 0) const { return fValues.data() + element; }
+
+      protected:
+        matrixStorage(): fValues() {}
+
+        std::array<FLOATING_POINT, SIZE> fValues;
+    };
+
+    //Pointers to the first lane of every element of a matrix or a column<> of matrices
+    template <class MATRIX, size_t ...ELEMENTS>
+    auto elementPointers(MATRIX& matrix, std::index_sequence<ELEMENTS...>) -> std::array<decltype(matrix.data(0)), sizeof...(ELEMENTS)>
+    {
+      return {{matrix.data(ELEMENTS)...}};
+    }
+
+    template <class MATRIX>
+    auto elementPointers(MATRIX& matrix) -> decltype(elementPointers(matrix, std::make_index_sequence<std::decay<MATRIX>::type::value_type::nElements>()))
+    {
+      return elementPointers(matrix, std::make_index_sequence<std::decay<MATRIX>::type::value_type::nElements>());
+    }
+
+    //Matrix algebra on the underlying numbers.  Each kernel works on LANES independent matrices at once:
+    //element k of matrix lane is at ptrs[k][first + lane].  A single matrix is just LANES = 1.
+    using expand = int[];
+
+    //out = J * C * J^T for an M x N jacobian J and an N x N packed C.  Unrolled at compile-time.
+    template <size_t M, size_t N, size_t LANES, class FLOATING_POINT>
+    struct similarityKernel
+    {
+      static void apply(const FLOATING_POINT* const* jac, const FLOATING_POINT* const* cov, FLOATING_POINT* const* out, const size_t first)
+      {
+        FLOATING_POINT product[M * N][LANES]; //J * C
+        fillProduct(jac, cov, product, first, std::make_index_sequence<M * N>());
+        fillResult(jac, product, out, first, std::make_index_sequence<packedSize(M)>());
+      }
+
+      template <size_t ...ELEMENTS>
+      static void fillProduct(const FLOATING_POINT* const* jac, const FLOATING_POINT* const* cov, FLOATING_POINT (&product)[M * N][LANES], const size_t first, std::index_sequence<ELEMENTS...>)
+      {
+        (void)expand{0, (productElement<ELEMENTS / N, ELEMENTS % N>(jac, cov, product, first, std::make_index_sequence<N>()), 0)...};
+      }
+
+      template <size_t ROW, size_t COL, size_t ...SUM>
+      static void productElement(const FLOATING_POINT* const* jac, const FLOATING_POINT* const* cov, FLOATING_POINT (&product)[M * N][LANES], const size_t first, std::index_sequence<SUM...>)
+      {
+        for(size_t lane = 0; lane < LANES; ++lane)
+        {
+          FLOATING_POINT sum = 0;
+          (void)expand{0, (sum += jac[ROW * N + SUM][first + lane] * cov[packedIndex(SUM, COL)][first + lane], 0)...};
+          product[ROW * N + COL][lane] = sum;
+        }
+      }
+
+      template <size_t ...ELEMENTS>
+      static void fillResult(const FLOATING_POINT* const* jac, const FLOATING_POINT (&product)[M * N][LANES], FLOATING_POINT* const* out, const size_t first, std::index_sequence<ELEMENTS...>)
+      {
+        (void)expand{0, (resultElement<packedRow(ELEMENTS), packedCol(ELEMENTS)>(jac, product, out, first, std::make_index_sequence<N>()), 0)...};
+      }
+
+      template <size_t ROW, size_t COL, size_t ...SUM>
+      static void resultElement(const FLOATING_POINT* const* jac, const FLOATING_POINT (&product)[M * N][LANES], FLOATING_POINT* const* out, const size_t first, std::index_sequence<SUM...>)
+      {
+        for(size_t lane = 0; lane < LANES; ++lane)
+        {
+          FLOATING_POINT sum = 0;
+          (void)expand{0, (sum += product[ROW * N + SUM][lane] * jac[COL * N + SUM][first + lane], 0)...};
+          out[packedIndex(ROW, COL)][first + lane] = sum;
+        }
+      }
+    };
+
+    //Cholesky decomposition and inversion of N x N packed matrices.  A matrix that isn't positive definite
+    //comes out full of NaNs.
+    template <size_t N, size_t LANES, class FLOATING_POINT>
+    struct choleskyKernel
+    {
+      using lanes = FLOATING_POINT[packedSize(N)][LANES];
+
+      static void factor(const FLOATING_POINT* const* in, lanes& lower, const size_t first)
+      {
+        for(size_t col = 0; col < N; ++col)
+        {
+          for(size_t row = col; row < N; ++row)
+          {
+            for(size_t lane = 0; lane < LANES; ++lane)
+            {
+              FLOATING_POINT sum = in[packedIndex(row, col)][first + lane];
+              for(size_t k = 0; k < col; ++k) sum -= lower[packedIndex(row, k)][lane] * lower[packedIndex(col, k)][lane];
+              lower[packedIndex(row, col)][lane] = (row == col)?std::sqrt(sum):sum / lower[packedIndex(col, col)][lane];
+            }
+          }
+        }
+      }
+
+      static void factor(const FLOATING_POINT* const* in, FLOATING_POINT* const* out, const size_t first)
+      {
+        lanes lower;
+        factor(in, lower, first);
+        for(size_t element = 0; element < packedSize(N); ++element)
+        {
+          for(size_t lane = 0; lane < LANES; ++lane) out[element][first + lane] = lower[element][lane];
+        }
+      }
+
+      //in^-1 = L^-T * L^-1
+      static void invert(const FLOATING_POINT* const* in, FLOATING_POINT* const* out, const size_t first)
+      {
+        lanes lower, inverseLower;
+        factor(in, lower, first);
+
+        for(size_t col = 0; col < N; ++col)
+        {
+          for(size_t lane = 0; lane < LANES; ++lane) inverseLower[packedIndex(col, col)][lane] = 1 / lower[packedIndex(col, col)][lane];
+
+          for(size_t row = col + 1; row < N; ++row)
+          {
+            for(size_t lane = 0; lane < LANES; ++lane)
+            {
+              FLOATING_POINT sum = 0;
+              for(size_t k = col; k < row; ++k) sum -= lower[packedIndex(row, k)][lane] * inverseLower[packedIndex(k, col)][lane];
+              inverseLower[packedIndex(row, col)][lane] = sum / lower[packedIndex(row, row)][lane];
+            }
+          }
+        }
+
+        for(size_t row = 0; row < N; ++row)
+        {
+          for(size_t col = 0; col <= row; ++col)
+          {
+            for(size_t lane = 0; lane < LANES; ++lane)
+            {
+              FLOATING_POINT sum = 0;
+              for(size_t k = row; k < N; ++k) sum += inverseLower[packedIndex(k, row)][lane] * inverseLower[packedIndex(k, col)][lane];
+              out[packedIndex(row, col)][first + lane] = sum;
+            }
+          }
+        }
+      }
+    };
+
+    //A column<> of matrices: one contiguous array per element
+    template <class MATRIX>
+    class matrixColumn
+    {
+      public:
+        using value_type = MATRIX;
+        using floating_point = typename MATRIX::floating_point;
+
+        matrixColumn() = default;
+
+        explicit matrixColumn(const size_t size)
+        {
+          resize(size);
+        }
+
+        MATRIX operator [](const size_t index) const
+        {
+          MATRIX matrix;
+          for(size_t element = 0; element < MATRIX::nElements; ++element) *matrix.data(element) = fValues[element][index];
+          return matrix;
+        }
+
+        void set(const size_t index, const MATRIX& matrix)
+        {
+          for(size_t element = 0; element < MATRIX::nElements; ++element) fValues[element][index] = *matrix.data(element);
+        }
+
+        void push_back(const MATRIX& matrix)
+        {
+          for(size_t element = 0; element < MATRIX::nElements; ++element) fValues[element].push_back(*matrix.data(element));
+        }
+
+        size_t size() const { return fValues[0].size(); }
+        bool empty() const { return fValues[0].empty(); }
+        void reserve(const size_t size) { for(auto& element: fValues) element.reserve(size); }
+        void resize(const size_t size) { for(auto& element: fValues) element.resize(size); }
+        void clear() { for(auto& element: fValues) element.clear(); }
+
+        //Contiguous array of element for every matrix in this column<>
+        floating_point* data(const size_t element) { return fValues[element].data(); }
+        const floating_point* data(const size_t element) const { return fValues[element].data(); }
+
+      private:
+        std::array<std::vector<floating_point>, MATRIX::nElements> fValues;
+    };
+  }
+
+  template <class ...UNITS>
+  class covMatrix: public detail::matrixStorage<typename detail::commonFloat<UNITS...>::type, detail::packedSize(sizeof...(UNITS))>
+  {
+    public:
+      using value_type = covMatrix<UNITS...>;
+      static constexpr size_t dimension = sizeof...(UNITS);
+
+      template <size_t ROW, size_t COL>
+      using element = detail::productOf<detail::nth<ROW, UNITS...>, detail::nth<COL, UNITS...>>;
+
+      template <size_t ROW, size_t COL>
+      element<ROW, COL> get() const
+      {
+        return element<ROW, COL>(this->fValues[detail::packedIndex(ROW, COL)]);
+      }
+
+      template <size_t ROW, size_t COL>
+      void set(const element<ROW, COL> value)
+      {
+        this->fValues[detail::packedIndex(ROW, COL)] = value.template in<element<ROW, COL>>();
+      }
+  };
+
+  template <class ...UNITS>
+  class weightMatrix: public detail::matrixStorage<typename detail::commonFloat<UNITS...>::type, detail::packedSize(sizeof...(UNITS))>
+  {
+    public:
+      using value_type = weightMatrix<UNITS...>;
+      static constexpr size_t dimension = sizeof...(UNITS);
+
+      template <size_t ROW, size_t COL>
+      using element = detail::inverseOf<detail::productOf<detail::nth<ROW, UNITS...>, detail::nth<COL, UNITS...>>>;
+
+      template <size_t ROW, size_t COL>
+      element<ROW, COL> get() const
+      {
+        return element<ROW, COL>(this->fValues[detail::packedIndex(ROW, COL)]);
+      }
+
+      template <size_t ROW, size_t COL>
+      void set(const element<ROW, COL> value)
+      {
+        this->fValues[detail::packedIndex(ROW, COL)] = value.template in<element<ROW, COL>>();
+      }
+  };
+
+  template <class ...UNITS>
+  class choleskyFactor: public detail::matrixStorage<typename detail::commonFloat<UNITS...>::type, detail::packedSize(sizeof...(UNITS))>
+  {
+    public:
+      using value_type = choleskyFactor<UNITS...>;
+      static constexpr size_t dimension = sizeof...(UNITS);
+
+      template <size_t ROW, size_t COL>
+      using element = detail::nth<ROW, UNITS...>;
+
+      template <size_t ROW, size_t COL>
+      element<ROW, COL> get() const
+      {
+        static_assert(ROW >= COL, "The upper triangle of a Cholesky factor is always 0!");
+        return element<ROW, COL>(this->fValues[detail::packedIndex(ROW, COL)]);
+      }
+  };
+
+  template <class TO, class FROM>
+  class jacobian;
+
+  template <class ...TO, class ...FROM>
+  class jacobian<std::tuple<TO...>, std::tuple<FROM...>>: public detail::matrixStorage<typename detail::commonFloat<TO..., FROM...>::type, sizeof...(TO) * sizeof...(FROM)>
+  {
+    public:
+      using value_type = jacobian<std::tuple<TO...>, std::tuple<FROM...>>;
+      static constexpr size_t rows = sizeof...(TO);
+      static constexpr size_t cols = sizeof...(FROM);
+
+      template <size_t ROW, size_t COL>
+      using element = detail::ratioOf<detail::nth<ROW, TO...>, detail::nth<COL, FROM...>>;
+
+      template <size_t ROW, size_t COL>
+      element<ROW, COL> get() const
+      {
+        return element<ROW, COL>(this->fValues[ROW * cols + COL]);
+      }
+
+      template <size_t ROW, size_t COL>
+      void set(const element<ROW, COL> value)
+      {
+        this->fValues[ROW * cols + COL] = value.template in<element<ROW, COL>>();
+      }
+  };
+
+  //column<>s of matrices for many tracks
+  template <class ...UNITS>
+  class column<covMatrix<UNITS...>>: public detail::matrixColumn<covMatrix<UNITS...>>
+  {
+    public:
+      using detail::matrixColumn<covMatrix<UNITS...>>::matrixColumn;
+  };
+
+  template <class ...UNITS>
+  class column<weightMatrix<UNITS...>>: public detail::matrixColumn<weightMatrix<UNITS...>>
+  {
+    public:
+      using detail::matrixColumn<weightMatrix<UNITS...>>::matrixColumn;
+  };
+
+  template <class ...UNITS>
+  class column<choleskyFactor<UNITS...>>: public detail::matrixColumn<choleskyFactor<UNITS...>>
+  {
+    public:
+      using detail::matrixColumn<choleskyFactor<UNITS...>>::matrixColumn;
+  };
+
+  template <class TO, class FROM>
+  class column<jacobian<TO, FROM>>: public detail::matrixColumn<jacobian<TO, FROM>>
+  {
+    public:
+      using detail::matrixColumn<jacobian<TO, FROM>>::matrixColumn;
+  };
+
+  namespace detail
+  {
+    //Run KERNEL over every track in a column<>, batchLanes tracks at a time
+    template <template <size_t> class KERNEL, class ...ARGS>
+    void forEachBlock(const size_t size, ARGS&... args)
+    {
+      size_t first = 0;
+      for(; first + batchLanes <= size; first += batchLanes) KERNEL<batchLanes>::apply(args.data()..., first);
+      for(; first < size; ++first) KERNEL<1>::apply(args.data()..., first);
+    }
+
+    template <size_t M, size_t N, class FLOATING_POINT>
+    struct similarityLanes
+    {
+      template <size_t LANES>
+      using kernel = similarityKernel<M, N, LANES, FLOATING_POINT>;
+    };
+
+    template <size_t N, class FLOATING_POINT>
+    struct choleskyLanes
+    {
+      template <size_t LANES>
+      struct factor
+      {
+        static void apply(const FLOATING_POINT* const* in, FLOATING_POINT* const* out, const size_t first)
+        {
+          choleskyKernel<N, LANES, FLOATING_POINT>::factor(in, out, first);
+        }
+      };
+
+      template <size_t LANES>
+      struct invert
+      {
+        static void apply(const FLOATING_POINT* const* in, FLOATING_POINT* const* out, const size_t first)
+        {
+          choleskyKernel<N, LANES, FLOATING_POINT>::invert(in, out, first);
+        }
+      };
+    };
+  }
+
+  //Propagate a covariance matrix through a change of parameters: J * cov * J^T
+  template <class ...TO, class ...FROM, class ...UNITS>
+  covMatrix<TO...> similarity(const jacobian<std::tuple<TO...>, std::tuple<FROM...>>& jac, const covMatrix<UNITS...>& cov)
+  {
+    static_assert(std::is_same<std::tuple<FROM...>, std::tuple<UNITS...>>::value, "A jacobian must transform from the units of the covariance matrix it's applied to!");
+    covMatrix<TO...> result;
+    auto jacPtrs = detail::elementPointers(jac);
+    auto covPtrs = detail::elementPointers(cov);
+    auto resultPtrs = detail::elementPointers(result);
+    detail::similarityKernel<sizeof...(TO), sizeof...(FROM), 1, typename covMatrix<TO...>::floating_point>::apply(jacPtrs.data(), covPtrs.data(), resultPtrs.data(), 0);
+    return result;
+  }
+
+  template <class ...UNITS>
+  choleskyFactor<UNITS...> cholesky(const covMatrix<UNITS...>& cov)
+  {
+    choleskyFactor<UNITS...> result;
+    auto covPtrs = detail::elementPointers(cov);
+    auto resultPtrs = detail::elementPointers(result);
+    detail::choleskyKernel<sizeof...(UNITS), 1, typename covMatrix<UNITS...>::floating_point>::factor(covPtrs.data(), resultPtrs.data(), 0);
+    return result;
+  }
+
+  template <class ...UNITS>
+  weightMatrix<UNITS...> inverse(const covMatrix<UNITS...>& cov)
+  {
+    weightMatrix<UNITS...> result;
+    auto covPtrs = detail::elementPointers(cov);
+    auto resultPtrs = detail::elementPointers(result);
+    detail::choleskyKernel<sizeof...(UNITS), 1, typename covMatrix<UNITS...>::floating_point>::invert(covPtrs.data(), resultPtrs.data(), 0);
+    return result;
+  }
+
+  template <class ...UNITS>
+  covMatrix<UNITS...> inverse(const weightMatrix<UNITS...>& weights)
+  {
+    covMatrix<UNITS...> result;
+    auto weightPtrs = detail::elementPointers(weights);
+    auto resultPtrs = detail::elementPointers(result);
+    detail::choleskyKernel<sizeof...(UNITS), 1, typename covMatrix<UNITS...>::floating_point>::invert(weightPtrs.data(), resultPtrs.data(), 0);
+    return result;
+  }
+
+  //Batch versions for column<>s of many tracks.  jac and cov must have the same size().
+  template <class ...TO, class ...FROM, class ...UNITS>
+  column<covMatrix<TO...>> similarity(const column<jacobian<std::tuple<TO...>, std::tuple<FROM...>>>& jac, const column<covMatrix<UNITS...>>& cov)
+  {
+    static_assert(std::is_same<std::tuple<FROM...>, std::tuple<UNITS...>>::value, "A jacobian must transform from the units of the covariance matrix it's applied to!");
+    assert(jac.size() == cov.size() && "similarity() needs one jacobian per covariance matrix!");
+    column<covMatrix<TO...>> result(cov.size());
+    auto jacPtrs = detail::elementPointers(jac);
+    auto covPtrs = detail::elementPointers(cov);
+    auto resultPtrs = detail::elementPointers(result);
+    detail::forEachBlock<detail::similarityLanes<sizeof...(TO), sizeof...(FROM), typename covMatrix<TO...>::floating_point>::template kernel>(cov.size(), jacPtrs, covPtrs, resultPtrs);
+    return result;
+  }
+
+  template <class ...UNITS>
+  column<choleskyFactor<UNITS...>> cholesky(const column<covMatrix<UNITS...>>& cov)
+  {
+    column<choleskyFactor<UNITS...>> result(cov.size());
+    auto covPtrs = detail::elementPointers(cov);
+    auto resultPtrs = detail::elementPointers(result);
+    detail::forEachBlock<detail::choleskyLanes<sizeof...(UNITS), typename covMatrix<UNITS...>::floating_point>::template factor>(cov.size(), covPtrs, resultPtrs);
+    return result;
+  }
+
+  template <class ...UNITS>
+  column<weightMatrix<UNITS...>> inverse(const column<covMatrix<UNITS...>>& cov)
+  {
+    column<weightMatrix<UNITS...>> result(cov.size());
+    auto covPtrs = detail::elementPointers(cov);
+    auto resultPtrs = detail::elementPointers(result);
+    detail::forEachBlock<detail::choleskyLanes<sizeof...(UNITS), typename covMatrix<UNITS...>::floating_point>::template invert>(cov.size(), covPtrs, resultPtrs);
+    return result;
+  }
+
+  template <class ...UNITS>
+  column<covMatrix<UNITS...>> inverse(const column<weightMatrix<UNITS...>>& weights)
+  {
+    column<covMatrix<UNITS...>> result(weights.size());
+    auto weightPtrs = detail::elementPointers(weights);
+    auto resultPtrs = detail::elementPointers(result);
+    detail::forEachBlock<detail::choleskyLanes<sizeof...(UNITS), typename covMatrix<UNITS...>::floating_point>::template invert>(weights.size(), weightPtrs, resultPtrs);
+    return result;
+  }
+}
+
+#endif //UNITS_COVARIANCE_H
@@ -0,0 +1,299 @@
+//File: cuts.h
+//Brief: Declarative event selection over column<>s.  Build a cut from
+//       unit-checked comparisons like field<0>() > 401_mm, combine cuts
+//       with &&, ||, and !, then evaluate it on a whole batch at once to
+//       get a bitmask of the rows that pass.
+//Author: Andrew Olivier aolivier@ur.rochester.edu
+
+//A cut doesn't know about any data until you evaluate() it.  field<INDEX>() stands for the INDEX-th column<> of
+//whatever batch you pass to evaluate(), so the same cut can be applied to every batch in a pipeline<>.  A batch is
+//anything std::get<>() works on, like a std::tuple<> of column<>s.  Use std::tie() to cut on column<>s you already
+//have.  All column<>s in a batch must have the same size().
+//
+//Rows and thresholds with different prefixes are compared the same way quantity<>'s comparison operators compare
+//them: both sides are scaled by compile-time integers from the ratio of their prefixes (see detail::comparison in
+//quantity.h).  So field<0>() > x passes exactly the rows where column[row] > x, even right at the threshold.  The
+//compiler refuses to compare column<>s and thresholds with different base units.  Rows are compared 64 at a time
+//into one word of the bitmask by a branch-free loop that the compiler can vectorize.  &&, ||, and ! work on whole
+//words.
+//
+//Example:
+//
+//const auto cut = units::field<0>() > 401_mm && !(units::field<1>() >= 2_GeV);
+//const units::bitmask passed = cut.evaluate(std::tie(distances, energies));
+//std::cout << passed.count() << " events passed\n";
+//const auto selectedEnergies = units::compact(energies, passed);
+
+#ifndef UNITS_CUTS_H
+#define UNITS_CUTS_H
+
+//units includes
+#include "units.h"
+
+//c++ includes
+#include <bitset>
+#include <cassert>
+#include <cstdint>
+#include <functional>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+namespace units
+{
+  //One bit per row.  Bits past size() are always 0.
+  class bitmask
+  {
+    public:
+      using word = std::uint64_t;
+      static constexpr size_t wordBits = 64;
+
+      bitmask(): fSize(0) {}
+
+      explicit bitmask(const size_t size, const bool value = false): fWords((size + wordBits - 1) / wordBits, value?~word(0):word(0)), fSize(size)
+      {
+        clearTail();
+      }
+
+      size_t size() const { return fSize; }
+      size_t nWords() const { return fWords.size(); }
+
+      bool test(const size_t row) const
+      {
+        return (fWords[row / wordBits] >> (row % wordBits)) & 1;
+      }
+
+      void set(const size_t row, const bool value)
+      {
+        const word bit = word(1) << (row % wordBits);
+        fWords[row / wordBits] = value?(fWords[row / wordBits] | bit):(fWords[row / wordBits] & ~bit);
+      }
+
+      //Number of rows that passed
+      size_t count() const
+      {
+        size_t sum = 0;
+        for(const auto bits: fWords) sum += std::bitset<wordBits>(bits).count();
+        return sum;
+      }
+
+      //Both bitmasks must have the same size()
+      bitmask& operator &=(const bitmask& other)
+      {
+        assert(fSize == other.fSize && "Combining bitmasks of different sizes!");
+        for(size_t index = 0; index < fWords.size(); ++index) fWords[index] &= other.fWords[index];
+        return *this;
+      }
+
+      bitmask& operator |=(const bitmask& other)
+      {
+        assert(fSize == other.fSize && "Combining bitmasks of different sizes!");
+        for(size_t index = 0; index < fWords.size(); ++index) fWords[index] |= other.fWords[index];
+        return *this;
+      }
+
+      bitmask operator ~() const
+      {
+        bitmask result(*this);
+        for(auto& bits: result.fWords) bits = ~bits;
+        result.clearTail();
+        return result;
+      }
+
+      //Raw words for external libraries.  Row i is bit i % 64 of word i / 64.
+      word* data() { return fWords.data(); }
+      const word* data() const { return fWords.data(); }
+
+    private:
+      void clearTail()
+      {
+        if(fSize % wordBits) fWords.back() &= (word(1) << (fSize % wordBits)) - 1;
+      }
+
+      std::vector<word> fWords;
+      size_t fSize;
+  };
+
+  inline bitmask operator &(bitmask lhs, const bitmask& rhs)
+  {
+    return lhs &= rhs;
+  }
+
+  inline bitmask operator |(bitmask lhs, const bitmask& rhs)
+  {
+    return lhs |= rhs;
+  }
+
+  //Base class for everything that can be evaluate()d into a bitmask.  Only cut<>s can be combined with &&, ||, and !.
+  template <class DERIVED>
+  struct cut
+  {
+    template <class BATCH>
+    bitmask evaluate(const BATCH& batch) const
+    {
+      return static_cast<const DERIVED&>(*this).evaluate(batch);
+    }
+  };
+
+  //Compare every row of the INDEX-th column<> in a batch to a threshold
+  template <size_t INDEX, class COMPARE, class QUANTITY>
+  class threshold: public cut<threshold<INDEX, COMPARE, QUANTITY>>
+  {
+    public:
+      threshold(const QUANTITY value): fValue(value) {}
+
+      template <class BATCH>
+      bitmask evaluate(const BATCH& batch) const
+      {
+        using column_t = typename std::decay<typename std::tuple_element<INDEX, BATCH>::type>::type;
+        using value_type = typename column_t::value_type;
+        static_assert(std::is_same<typename value_type::tag, typename QUANTITY::tag>::value, "You cannot cut on a quantity with different base units!");
+
+        using scale = detail::comparison<std::ratio_divide<typename value_type::prefix, typename QUANTITY::prefix>, typename value_type::floating_point>;
+
+        const auto& values = std::get<INDEX>(batch);
+        const auto limit = scale::rhs(fValue.template in<QUANTITY>()); //Scaled once for the whole column
+        const auto data = values.data();
+        const COMPARE compare;
+
+        bitmask result(values.size());
+        auto words = result.data();
+        const size_t nFull = values.size() / bitmask::wordBits;
+        for(size_t index = 0; index < nFull; ++index)
+        {
+          bitmask::word bits = 0;
+          for(size_t bit = 0; bit < bitmask::wordBits; ++bit) bits |= bitmask::word(compare(scale::lhs(data[index * bitmask::wordBits + bit]), limit)) << bit;
+          words[index] = bits;
+        }
+
+        for(size_t row = nFull * bitmask::wordBits; row < values.size(); ++row) result.set(row, compare(scale::lhs(data[row]), limit));
+
+        return result;
+      }
+
+    private:
+      QUANTITY fValue;
+  };
+
+  template <class LHS, class RHS>
+  class both: public cut<both<LHS, RHS>>
+  {
+    public:
+      both(const LHS& lhs, const RHS& rhs): fLHS(lhs), fRHS(rhs) {}
+
+      template <class BATCH>
+      bitmask evaluate(const BATCH& batch) const
+      {
+        auto result = fLHS.evaluate(batch);
+        result &= fRHS.evaluate(batch);
+        return result;
+      }
+
+    private:
+      LHS fLHS;
+      RHS fRHS;
+  };
+
+  template <class LHS, class RHS>
+  class either: public cut<either<LHS, RHS>>
+  {
+    public:
+      either(const LHS& lhs, const RHS& rhs): fLHS(lhs), fRHS(rhs) {}
+
+      template <class BATCH>
+      bitmask evaluate(const BATCH& batch) const
+      {
+        auto result = fLHS.evaluate(batch);
+        result |= fRHS.evaluate(batch);
+        return result;
+      }
+
+    private:
+      LHS fLHS;
+      RHS fRHS;
+  };
+
+  template <class CUT>
+  class negation: public cut<negation<CUT>>
+  {
+    public:
+      negation(const CUT& other): fCut(other) {}
+
+      template <class BATCH>
+      bitmask evaluate(const BATCH& batch) const
+      {
+        return ~fCut.evaluate(batch);
+      }
+
+    private:
+      CUT fCut;
+  };
+
+  template <class LHS, class RHS>
+  both<LHS, RHS> operator &&(const cut<LHS>& lhs, const cut<RHS>& rhs)
+  {
+    return both<LHS, RHS>(static_cast<const LHS&>(lhs), static_cast<const RHS&>(rhs));
+  }
+
+  template <class LHS, class RHS>
+  either<LHS, RHS> operator ||(const cut<LHS>& lhs, const cut<RHS>& rhs)
+  {
+    return either<LHS, RHS>(static_cast<const LHS&>(lhs), static_cast<const RHS&>(rhs));
+  }
+
+  template <class CUT>
+  negation<CUT> operator !(const cut<CUT>& other)
+  {
+    return negation<CUT>(static_cast<const CUT&>(other));
+  }
+
+  //Placeholder for the INDEX-th column<> of a batch.  Comparing it to a quantity<> makes a cut.
+  template <size_t INDEX>
+  struct field
+  {
+    template <class BASE_TAG, class PREFIX, class FLOATING_POINT>
+    threshold<INDEX, std::less<FLOATING_POINT>, quantity<BASE_TAG, PREFIX, FLOATING_POINT>> operator <(const quantity<BASE_TAG, PREFIX, FLOATING_POINT> value) const
+    {
+      return value;
+    }
+
+    template <class BASE_TAG, class PREFIX, class FLOATING_POINT>
+    threshold<INDEX, std::greater<FLOATING_POINT>, quantity<BASE_TAG, PREFIX, FLOATING_POINT>> operator >(const quantity<BASE_TAG, PREFIX, FLOATING_POINT> value) const
+    {
+      return value;
+    }
+
+    template <class BASE_TAG, class PREFIX, class FLOATING_POINT>
+    threshold<INDEX, std::less_equal<FLOATING_POINT>, quantity<BASE_TAG, PREFIX, FLOATING_POINT>> operator <=(const quantity<BASE_TAG, PREFIX, FLOATING_POINT> value) const
+    {
+      return value;
+    }
+
+    template <class BASE_TAG, class PREFIX, class FLOATING_POINT>
+    threshold<INDEX, std::greater_equal<FLOATING_POINT>, quantity<BASE_TAG, PREFIX, FLOATING_POINT>> operator >=(const quantity<BASE_TAG, PREFIX, FLOATING_POINT> value) const
+    {
+      return value;
+    }
+  };
+
+  //Keep only the rows of a column<> that passed.  Branch-free: every row is written, but only passing rows
+  //advance the output position.  passed must have one bit per row of values.
+  template <class QUANTITY>
+  column<QUANTITY> compact(const column<QUANTITY>& values, const bitmask& passed)
+  {
+    assert(passed.size() == values.size() && "compact() needs one bit per row!");
+    column<QUANTITY> result(values.size());
+    auto out = result.data();
+    const auto in = values.data();
+    size_t nPassed = 0;
+    for(size_t row = 0; row < values.size(); ++row)
+    {
+      out[nPassed] = in[row];
+      nPassed += passed.test(row);
+    }
+    result.resize(nPassed);
+    return result;
+  }
+}
+
+#endif //UNITS_CUTS_H
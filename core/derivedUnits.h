@@ -20,6 +20,11 @@ namespace units
   
   //TODO: productTag<V, U> should be the same as productTag<U, V>.  I'll fix this if I ever need it.
   //TODO: Group like units so that cm * MeV * cm becomes cm^2 * MeV
+  //Nota Bene: Units don't cancel yet either.  MeV / cm * cm is not MeV, so formulas that rely on cancellation, like
+  //           a covariance matrix similarity transform or a Runge-Kutta step, are done on the underlying numbers
+  //           instead.  covariance.h and integrators.h keep each number in the prefix of its own units so that
+  //           prefixes cancel without conversions, and the compiler still checks the units of what goes in and
+  //           comes out.
   template <class ...PRODS>
   class productTag
   {
@@ -0,0 +1,290 @@
+//File: integrators.h
+//Brief: Integrate ordinary differential equations like dE/dx along a
+//       particle's path without taking quantity<>s apart into doubles.
+//       rk4() takes fixed steps.  dormandPrince() adapts its step size
+//       to meet a tolerance.  Both also step a whole column<> of
+//       independent particles at once.
+//Author: Andrew Olivier aolivier@ur.rochester.edu
+
+//You integrate d(STATE)/d(STEP) = derivative(position, state).  The units of the derivative are inferred from the
+//units of the state and of the step size: derivativeOf<MeV, cm> is MeV / cm.  derivative is called with a position
+//in the units of the step size and a STATE, and the compiler refuses to integrate it unless it returns something
+//in the units of STATE / STEP.  Integration limits and step sizes have to be in the units of STEP, and absolute
+//tolerances in the units of STATE.  Prefixes are converted for you like everywhere else in this library, so a
+//derivative that returns MeV / cm works with a step size in mm.
+//
+//state + derivative * step is only in the units of STATE once units cancel (see the Nota Bene in derivedUnits.h),
+//so the integrators work on the underlying numbers.
+//
+//Integration always runs forward.  rk4() and dormandPrince() throw std::invalid_argument if end is before start
+//or the step size isn't positive.  dormandPrince() throws std::runtime_error if it hasn't reached end after
+//maxSteps attempts, or if meeting the tolerance would take a step too small to move the position forward.
+//
+//The column<> versions step batchLanes particles together in their innermost loops so that the compiler can
+//vectorize them.  Keep derivative small enough to inline for that to pay off.  All particles share the same start
+//and end.  dormandPrince() gives each particle its own step size.
+//
+//Example:
+//
+//using dEdx_t = units::derivativeOf<MeV, cm>;
+//const auto energyLoss = [](const cm /*x*/, const MeV energy) { return dEdx_t(-4000. / energy.in<MeV>()); };
+//const MeV energy = units::rk4(energyLoss, 1_GeV, 0_cm, 100_cm, 1_mm);
+//const MeV adaptiveEnergy = units::dormandPrince(energyLoss, 1_GeV, 0_cm, 100_cm, 1_cm, 1e-6_MeV, 1e-8);
+
+#ifndef UNITS_INTEGRATORS_H
+#define UNITS_INTEGRATORS_H
+
+//units includes
+#include "units.h"
+
+//c++ includes
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+
+namespace units
+{
+  //Units of d(STATE)/d(STEP)
+  template <class STATE, class STEP>
+  using derivativeOf = quantity<typename buildRatio<typename STATE::tag, typename STEP::tag>::result,
+                                std::ratio_divide<typename STATE::prefix, typename STEP::prefix>, typename STATE::floating_point>;
+
+  namespace detail
+  {
+    //Does QUANTITY have the same base units as EXPECTED?  Plain numbers never do.
+    template <class QUANTITY, class EXPECTED>
+    struct sameUnits: std::false_type
+    {
+    };
+
+    template <class BASE_TAG, class PREFIX, class FLOATING_POINT, class EXPECTED>
+    struct sameUnits<quantity<BASE_TAG, PREFIX, FLOATING_POINT>, EXPECTED>: std::is_same<BASE_TAG, typename EXPECTED::tag>
+    {
+    };
+
+    //Checks shared by all integrators
+    template <class DERIVATIVE, class STATE, class STEP, class START, class END, class TOLERANCE = STATE>
+    struct checkIntegrator
+    {
+      static_assert(sameUnits<STATE, STATE>::value && sameUnits<STEP, STEP>::value, "Integrators only work on quantity<>s!");
+      static_assert(sameUnits<typename std::result_of<const DERIVATIVE&(STEP, STATE)>::type, derivativeOf<STATE, STEP>>::value,
+                    "A derivative must have the units of state / step!");
+      static_assert(sameUnits<START, STEP>::value && sameUnits<END, STEP>::value, "Integration limits must have the same units as the step size!");
+      static_assert(sameUnits<TOLERANCE, STATE>::value, "An absolute tolerance must have the same units as the state!");
+    };
+
+    //Evaluate derivative on underlying numbers in the prefixes of STEP and STATE.  The result is in the prefix of
+    //derivativeOf<STATE, STEP>, so state + slope * step is in the prefix of STATE.
+    template <class STATE, class STEP, class DERIVATIVE>
+    inline typename STATE::floating_point slope(const DERIVATIVE& derivative, const typename STATE::floating_point position, const typename STATE::floating_point state)
+    {
+      using slope_t = derivativeOf<STATE, STEP>;
+      return slope_t(derivative(STEP(position), STATE(state))).template in<slope_t>();
+    }
+
+    //nSteps classic 4th order Runge-Kutta steps of size step for LANES particles at once
+    template <size_t LANES, class STATE, class STEP, class DERIVATIVE>
+    struct rk4Kernel
+    {
+      using fp = typename STATE::floating_point;
+
+      static void apply(const DERIVATIVE& derivative, fp* states, const fp start, const fp step, const size_t nSteps)
+      {
+        fp y[LANES], k1[LANES], k2[LANES], k3[LANES], k4[LANES];
+        for(size_t lane = 0; lane < LANES; ++lane) y[lane] = states[lane];
+
+        for(size_t stepNumber = 0; stepNumber < nSteps; ++stepNumber)
+        {
+          const fp x = start + stepNumber * step;
+          for(size_t lane = 0; lane < LANES; ++lane) k1[lane] = slope<STATE, STEP>(derivative, x, y[lane]);
+          for(size_t lane = 0; lane < LANES; ++lane) k2[lane] = slope<STATE, STEP>(derivative, x + step/2, y[lane] + step/2 * k1[lane]);
+          for(size_t lane = 0; lane < LANES; ++lane) k3[lane] = slope<STATE, STEP>(derivative, x + step/2, y[lane] + step/2 * k2[lane]);
+          for(size_t lane = 0; lane < LANES; ++lane) k4[lane] = slope<STATE, STEP>(derivative, x + step, y[lane] + step * k3[lane]);
+          for(size_t lane = 0; lane < LANES; ++lane) y[lane] += step/6 * (k1[lane] + 2*k2[lane] + 2*k3[lane] + k4[lane]);
+        }
+
+        for(size_t lane = 0; lane < LANES; ++lane) states[lane] = y[lane];
+      }
+    };
+
+    //Adaptive Dormand-Prince 5(4) steps for LANES particles at once.  Every particle has its own position and step
+    //size.  Particles that have reached end keep taking steps of size 0 until the rest catch up.  The last stage of
+    //an accepted step is reused as the first stage of the next one.
+    template <size_t LANES, class STATE, class STEP, class DERIVATIVE>
+    struct dormandPrinceKernel
+    {
+      using fp = typename STATE::floating_point;
+
+      static void apply(const DERIVATIVE& derivative, fp* states, const fp start, const fp end, const fp initialStep,
+                        const fp absTolerance, const fp relTolerance, const size_t maxSteps)
+      {
+        //Smallest step that still moves x forward anywhere between start and end
+        const fp minStep = 16 * std::numeric_limits<fp>::epsilon() * std::max(std::fabs(start), std::fabs(end));
+
+        fp x[LANES], h[LANES], y[LANES], yNew[LANES], yStage[LANES];
+        fp k1[LANES], k2[LANES], k3[LANES], k4[LANES], k5[LANES], k6[LANES], k7[LANES];
+        for(size_t lane = 0; lane < LANES; ++lane)
+        {
+          x[lane] = start;
+          y[lane] = states[lane];
+          k1[lane] = slope<STATE, STEP>(derivative, start, y[lane]);
+        }
+
+        for(size_t lane = 0; lane < LANES; ++lane) h[lane] = initialStep;
+
+        for(size_t attempt = 0; attempt < maxSteps; ++attempt)
+        {
+          bool active = false;
+          for(size_t lane = 0; lane < LANES; ++lane) active |= (x[lane] < end);
+          if(!active) break;
+
+          //The last step of a particle can be as small as it needs to be to land on end.  Any other step below
+          //minStep would be rounded away.
+          bool stalled = false;
+          for(size_t lane = 0; lane < LANES; ++lane) stalled |= (x[lane] < end) && (h[lane] < std::min(minStep, end - x[lane]));
+          if(stalled) throw std::runtime_error("dormandPrince needs a step too small to move forward.  The tolerance may be too tight.");
+
+          fp step[LANES];
+          for(size_t lane = 0; lane < LANES; ++lane) step[lane] = std::min(h[lane], end - x[lane]);
+
+          for(size_t lane = 0; lane < LANES; ++lane) yStage[lane] = y[lane] + step[lane] * (fp(1)/5 * k1[lane]);
+          for(size_t lane = 0; lane < LANES; ++lane) k2[lane] = slope<STATE, STEP>(derivative, x[lane] + step[lane] / 5, yStage[lane]);
+
+          for(size_t lane = 0; lane < LANES; ++lane) yStage[lane] = y[lane] + step[lane] * (fp(3)/40 * k1[lane] + fp(9)/40 * k2[lane]);
+          for(size_t lane = 0; lane < LANES; ++lane) k3[lane] = slope<STATE, STEP>(derivative, x[lane] + step[lane] * 3 / 10, yStage[lane]);
+
+          for(size_t lane = 0; lane < LANES; ++lane) yStage[lane] = y[lane] + step[lane] * (fp(44)/45 * k1[lane] - fp(56)/15 * k2[lane] + fp(32)/9 * k3[lane]);
+          for(size_t lane = 0; lane < LANES; ++lane) k4[lane] = slope<STATE, STEP>(derivative, x[lane] + step[lane] * 4 / 5, yStage[lane]);
+
+          for(size_t lane = 0; lane < LANES; ++lane) yStage[lane] = y[lane] + step[lane] * (fp(19372)/6561 * k1[lane] - fp(25360)/2187 * k2[lane] + fp(64448)/6561 * k3[lane]
+                                                                                            - fp(212)/729 * k4[lane]);
+          for(size_t lane = 0; lane < LANES; ++lane) k5[lane] = slope<STATE, STEP>(derivative, x[lane] + step[lane] * 8 / 9, yStage[lane]);
+
+          for(size_t lane = 0; lane < LANES; ++lane) yStage[lane] = y[lane] + step[lane] * (fp(9017)/3168 * k1[lane] - fp(355)/33 * k2[lane] + fp(46732)/5247 * k3[lane]
+                                                                                            + fp(49)/176 * k4[lane] - fp(5103)/18656 * k5[lane]);
+          for(size_t lane = 0; lane < LANES; ++lane) k6[lane] = slope<STATE, STEP>(derivative, x[lane] + step[lane], yStage[lane]);
+
+          //5th order solution
+          for(size_t lane = 0; lane < LANES; ++lane) yNew[lane] = y[lane] + step[lane] * (fp(35)/384 * k1[lane] + fp(500)/1113 * k3[lane] + fp(125)/192 * k4[lane]
+                                                                                          - fp(2187)/6784 * k5[lane] + fp(11)/84 * k6[lane]);
+          for(size_t lane = 0; lane < LANES; ++lane) k7[lane] = slope<STATE, STEP>(derivative, x[lane] + step[lane], yNew[lane]);
+
+          //Difference from the embedded 4th order solution decides whether to accept this step and how big the next one is
+          for(size_t lane = 0; lane < LANES; ++lane)
+          {
+            const fp error = step[lane] * (fp(71)/57600 * k1[lane] - fp(71)/16695 * k3[lane] + fp(71)/1920 * k4[lane] - fp(17253)/339200 * k5[lane]
+                                           + fp(22)/525 * k6[lane] - fp(1)/40 * k7[lane]);
+            const fp scale = absTolerance + relTolerance * std::max(std::fabs(y[lane]), std::fabs(yNew[lane]));
+            const fp ratio = std::fabs(error) / scale;
+            const bool accept = (ratio <= 1);
+            const fp growth = std::min(accept?fp(5):fp(1), std::max(fp(0.2), fp(0.9) * std::pow(ratio, fp(-0.2))));
+
+            const bool moving = (x[lane] < end);
+            x[lane] = (moving && accept)?((step[lane] == end - x[lane])?end:x[lane] + step[lane]):x[lane];
+            y[lane] = (moving && accept)?yNew[lane]:y[lane];
+            k1[lane] = (moving && accept)?k7[lane]:k1[lane];
+            h[lane] = moving?step[lane] * growth:h[lane];
+          }
+        }
+
+        bool finished = true;
+        for(size_t lane = 0; lane < LANES; ++lane) finished &= (x[lane] >= end);
+        if(!finished) throw std::runtime_error("dormandPrince ran out of steps before reaching the end of integration.");
+
+        for(size_t lane = 0; lane < LANES; ++lane) states[lane] = y[lane];
+      }
+    };
+
+    //Integration runs forward with positive steps.  Also rejects NaNs.
+    template <class FLOATING_POINT>
+    void checkLimits(const FLOATING_POINT start, const FLOATING_POINT end, const FLOATING_POINT step)
+    {
+      if(!(step > 0)) throw std::invalid_argument("Integrators need a positive step size.");
+      if(!(end >= start)) throw std::invalid_argument("Integration has to end after it starts.");
+    }
+
+    //Number of equal steps no bigger than step from start to end.  Call checkLimits() first.
+    template <class FLOATING_POINT>
+    size_t nSteps(const FLOATING_POINT start, const FLOATING_POINT end, const FLOATING_POINT step)
+    {
+      return static_cast<size_t>(std::ceil((end - start) / step));
+    }
+  }
+
+  //Integrate from start to end with the classic 4th order Runge-Kutta method.  Takes equal steps that are no
+  //bigger than step and end exactly at end.
+  template <class DERIVATIVE, class STATE, class START, class END, class STEP>
+  STATE rk4(const DERIVATIVE& derivative, const STATE state, const START start, const END end, const STEP step)
+  {
+    (void)detail::checkIntegrator<DERIVATIVE, STATE, STEP, START, END>();
+    using fp = typename STATE::floating_point;
+    const fp first = start.template in<STEP>(), last = end.template in<STEP>(), maxSize = step.template in<STEP>();
+    detail::checkLimits(first, last, maxSize);
+    const size_t nSteps = detail::nSteps(first, last, maxSize);
+
+    fp result = state.template in<STATE>();
+    if(nSteps > 0) detail::rk4Kernel<1, STATE, STEP, DERIVATIVE>::apply(derivative, &result, first, (last - first) / nSteps, nSteps);
+    return STATE(result);
+  }
+
+  //Integrate from start to end with the adaptive Dormand-Prince method.  The error on each step is kept below
+  //absTolerance + relTolerance * |state|.  Gives up after maxSteps attempted steps by throwing std::runtime_error.
+  template <class DERIVATIVE, class STATE, class START, class END, class STEP, class TOLERANCE>
+  STATE dormandPrince(const DERIVATIVE& derivative, const STATE state, const START start, const END end, const STEP initialStep,
+                      const TOLERANCE absTolerance, const typename STATE::floating_point relTolerance, const size_t maxSteps = 100000)
+  {
+    (void)detail::checkIntegrator<DERIVATIVE, STATE, STEP, START, END, TOLERANCE>();
+    using fp = typename STATE::floating_point;
+    const fp first = start.template in<STEP>(), last = end.template in<STEP>(), h = initialStep.template in<STEP>();
+    detail::checkLimits(first, last, h);
+
+    fp result = state.template in<STATE>();
+    detail::dormandPrinceKernel<1, STATE, STEP, DERIVATIVE>::apply(derivative, &result, first, last, h, absTolerance.template in<STATE>(), relTolerance, maxSteps);
+    return STATE(result);
+  }
+
+  //Batch versions for column<>s of independent particles
+  template <class DERIVATIVE, class STATE, class START, class END, class STEP>
+  column<STATE> rk4(const DERIVATIVE& derivative, const column<STATE>& states, const START start, const END end, const STEP step)
+  {
+    (void)detail::checkIntegrator<DERIVATIVE, STATE, STEP, START, END>();
+    using fp = typename STATE::floating_point;
+    const fp first = start.template in<STEP>(), last = end.template in<STEP>(), maxSize = step.template in<STEP>();
+    detail::checkLimits(first, last, maxSize);
+    const size_t nSteps = detail::nSteps(first, last, maxSize);
+
+    column<STATE> result(states);
+    if(nSteps == 0) return result;
+
+    const fp size = (last - first) / nSteps;
+    auto data = result.data();
+    size_t row = 0;
+    for(; row + detail::batchLanes <= result.size(); row += detail::batchLanes) detail::rk4Kernel<detail::batchLanes, STATE, STEP, DERIVATIVE>::apply(derivative, data + row, first, size, nSteps);
+    for(; row < result.size(); ++row) detail::rk4Kernel<1, STATE, STEP, DERIVATIVE>::apply(derivative, data + row, first, size, nSteps);
+    return result;
+  }
+
+  template <class DERIVATIVE, class STATE, class START, class END, class STEP, class TOLERANCE>
+  column<STATE> dormandPrince(const DERIVATIVE& derivative, const column<STATE>& states, const START start, const END end, const STEP initialStep,
+                              const TOLERANCE absTolerance, const typename STATE::floating_point relTolerance, const size_t maxSteps = 100000)
+  {
+    (void)detail::checkIntegrator<DERIVATIVE, STATE, STEP, START, END, TOLERANCE>();
+    using fp = typename STATE::floating_point;
+    const fp first = start.template in<STEP>(), last = end.template in<STEP>(), h = initialStep.template in<STEP>(), tolerance = absTolerance.template in<STATE>();
+    detail::checkLimits(first, last, h);
+
+    column<STATE> result(states);
+    auto data = result.data();
+    size_t row = 0;
+    for(; row + detail::batchLanes <= result.size(); row += detail::batchLanes)
+    {
+      detail::dormandPrinceKernel<detail::batchLanes, STATE, STEP, DERIVATIVE>::apply(derivative, data + row, first, last, h, tolerance, relTolerance, maxSteps);
+    }
+    for(; row < result.size(); ++row) detail::dormandPrinceKernel<1, STATE, STEP, DERIVATIVE>::apply(derivative, data + row, first, last, h, tolerance, relTolerance, maxSteps);
+    return result;
+  }
+}
+
+#endif //UNITS_INTEGRATORS_H
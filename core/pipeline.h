@@ -0,0 +1,284 @@
+//File: pipeline.h
+//Brief: Overlap reading, unit conversion, calibration, and analysis of
+//       batches of events.  A pipeline<> is a chain of stage<>s, and the
+//       compiler checks that each stage<>'s input units match the units
+//       that the previous stage<> produces.
+//Author: Andrew Olivier aolivier@ur.rochester.edu
+
+//Not included by units.h because it needs your threading library.  With CMake, link against
+//${CMAKE_THREAD_LIBS_INIT}.
+//
+//A stage<> is a function from one batch type to another, like column<GeV> to column<MeV>.  Batches can be
+//anything default constructible and movable: a column<>, a std::tuple<> of column<>s, or your own
+//structure-of-arrays.  Each stage<> declares its input and output types, so an output of column<cm> can
+//never be fed into a stage<> that expects column<MeV>.  Outputs that differ only by a prefix, like column<mm>
+//into column<cm>, are converted between stages just like quantity<>s are.
+//
+//How a pipeline<> runs:
+//*) The source is called on a dedicated thread so that slow I/O never ties up a worker.  It always reads the
+//   next batch while the batches before it are being processed: double-buffered prefetch.
+//*) Every stage<> runs on the threadPool.  Different batches can be in different stage<>s, or the same
+//   stage<>, at the same time, so stage<>s must be safe to call concurrently.
+//*) Batches are handed between stage<>s through lock-free boundedQueue<>s.
+//*) The sink is called on the thread that called run(), one batch at a time, so it can fill histograms
+//   without locks.  Batches reach the sink in whatever order they finish.
+//*) At most maxInFlight batches are between the source and the sink at once.  That bounds memory use and
+//   guarantees that no queue ever fills up.
+//*) If the source or the sink throws, run() stops reading, waits for the batches in flight, and rethrows.
+//   stage<>s run on the threadPool, so they must not throw.
+//
+//Example:
+//
+//units::threadPool pool;
+//auto toMeV = units::makeStage<units::column<GeV>, units::column<MeV>>([](units::column<GeV>&& energies) { return units::column<MeV>(energies); });
+//auto calibrate = units::makeStage<units::column<MeV>, units::column<MeV>>(myCalibration);
+//auto chain = units::makePipeline(pool, toMeV, calibrate);
+//chain.run([&file](units::column<GeV>& next) { return file.read(next); },
+//          [&hist](units::column<MeV>&& energies) { for(size_t hit = 0; hit < energies.size(); ++hit) hist.Fill(energies[hit].in<MeV>()); });
+
+#ifndef UNITS_PIPELINE_H
+#define UNITS_PIPELINE_H
+
+//units includes
+#include "units.h"
+#include "boundedQueue.h"
+#include "threadPool.h"
+
+//c++ includes
+#include <exception>
+#include <tuple>
+#include <type_traits>
+
+namespace units
+{
+  //A stage<> of a pipeline<> with explicit input and output batch types.  FUNC is called as
+  //OUTPUT FUNC(INPUT&&) const.
+  template <class INPUT, class OUTPUT, class FUNC>
+  class stage
+  {
+    public:
+      //typedefs that pipeline<> checks
+      using input = INPUT;
+      using output = OUTPUT;
+
+      stage(FUNC func): fFunc(std::move(func)) {}
+
+      OUTPUT operator ()(INPUT&& batch) const
+      {
+        return fFunc(std::move(batch));
+      }
+
+    private:
+      FUNC fFunc;
+  };
+
+  template <class INPUT, class OUTPUT, class FUNC>
+  stage<INPUT, OUTPUT, FUNC> makeStage(FUNC func)
+  {
+    static_assert(std::is_convertible<typename std::result_of<const FUNC(INPUT&&)>::type, OUTPUT>::value, "A stage's function doesn't return the units it declares as its output!");
+    return stage<INPUT, OUTPUT, FUNC>(std::move(func));
+  }
+
+  namespace detail
+  {
+    //Check at compile-time that each stage<> can consume the previous stage<>'s output
+    template <class ...STAGES>
+    struct checkChain
+    {
+    };
+
+    template <class FIRST, class SECOND, class ...REST>
+    struct checkChain<FIRST, SECOND, REST...>: checkChain<SECOND, REST...>
+    {
+      static_assert(std::is_convertible<typename FIRST::output, typename SECOND::input>::value, "A stage's input units don't match the previous stage's output units!");
+    };
+
+    template <class ...STAGES>
+    using lastStage = typename std::tuple_element<sizeof...(STAGES) - 1, std::tuple<STAGES...>>::type;
+  }
+
+  template <class ...STAGES>
+  class pipeline: detail::checkChain<STAGES...>
+  {
+    static_assert(sizeof...(STAGES) > 0, "A pipeline needs at least one stage!");
+
+    public:
+      using input = typename std::tuple_element<0, std::tuple<STAGES...>>::type::input;
+      using output = typename detail::lastStage<STAGES...>::output;
+
+      pipeline(threadPool& pool, const size_t maxInFlight, STAGES... stages): fPool(pool), fMaxInFlight(std::max<size_t>(maxInFlight, 1)), fStages(std::move(stages)...) {}
+
+      //SOURCE is called as bool SOURCE(input& next).  It returns false when there are no more batches.
+      //SINK is called as SINK(output&& result).
+      //Returns the number of batches that went through the pipeline<>.
+      template <class SOURCE, class SINK>
+      size_t run(SOURCE&& source, SINK&& sink)
+      {
+        auto state = std::make_shared<running>(*this);
+
+        std::thread reader([&source, state]
+        {
+          try
+          {
+            input next;
+            while(source(next))
+            {
+              //Wait for room while holding on to the batch that was just read
+              {
+                std::unique_lock<std::mutex> lock(state->mutex);
+                state->progress.wait(lock, [&state] { return state->stop || state->produced - state->consumed < state->owner.fMaxInFlight; });
+                if(state->stop) break;
+                ++state->produced;
+              }
+
+              state->push(std::get<0>(state->queues), std::move(next));
+              state->owner.fPool.submit([state] { state->template process<0>(); });
+              next = input();
+            }
+          }
+          catch(...)
+          {
+            std::lock_guard<std::mutex> lock(state->mutex);
+            state->sourceError = std::current_exception();
+          }
+
+          std::lock_guard<std::mutex> lock(state->mutex);
+          state->readerDone = true;
+          state->progress.notify_all();
+        });
+        const readerGuard guard(reader, *state);
+
+        while(true)
+        {
+          {
+            std::unique_lock<std::mutex> lock(state->mutex);
+            state->progress.wait(lock, [&state] { return state->finished > state->consumed || (state->readerDone && state->consumed == state->produced); });
+            if(state->finished == state->consumed) break;
+          }
+
+          output result;
+          state->pop(state->results, result);
+          sink(std::move(result));
+
+          std::lock_guard<std::mutex> lock(state->mutex);
+          ++state->consumed;
+          state->progress.notify_all();
+        }
+
+        //The reader is done, so nobody else touches sourceError
+        if(state->sourceError) std::rethrow_exception(state->sourceError);
+        return state->consumed;
+      }
+
+    private:
+      template <class STAGE>
+      using queueFor = boundedQueue<typename STAGE::input>;
+
+      //Expands to one capacity per stage<> so that boundedQueue<>s, which can't be moved, are built in place
+      template <class STAGE>
+      static size_t capacity(const size_t maxInFlight) { return maxInFlight; }
+
+      //Everything one call to run() shares with its tasks.  Tasks keep it alive with a shared_ptr<>.
+      struct running: public std::enable_shared_from_this<running>
+      {
+        running(pipeline& parent): owner(parent), queues(capacity<STAGES>(parent.fMaxInFlight)...), results(parent.fMaxInFlight),
+                                   produced(0), consumed(0), finished(0), readerDone(false), stop(false)
+        {
+        }
+
+        pipeline& owner;
+        std::tuple<queueFor<STAGES>...> queues;
+        boundedQueue<output> results;
+
+        std::mutex mutex;
+        std::condition_variable progress;
+        size_t produced; //Batches read by the source
+        size_t consumed; //Batches given to the sink
+        size_t finished; //Batches through the last stage
+        bool readerDone;
+        bool stop; //Tells the reader to quit early
+        std::exception_ptr sourceError; //What the source threw, if anything
+
+        template <size_t STAGE>
+        void process()
+        {
+          using thisStage = typename std::tuple_element<STAGE, std::tuple<STAGES...>>::type;
+          typename thisStage::input batch;
+          pop(std::get<STAGE>(queues), batch);
+          forward<STAGE>(std::get<STAGE>(owner.fStages)(std::move(batch)), std::integral_constant<bool, STAGE + 1 == sizeof...(STAGES)>());
+        }
+
+        //Hand a batch to the next stage<>, converting units if needed
+        template <size_t STAGE, class RESULT>
+        void forward(RESULT&& batch, std::false_type)
+        {
+          using nextStage = typename std::tuple_element<STAGE + 1, std::tuple<STAGES...>>::type;
+          push(std::get<STAGE + 1>(queues), typename nextStage::input(std::move(batch)));
+          auto self = this->shared_from_this();
+          owner.fPool.submit([self] { self->template process<STAGE + 1>(); });
+        }
+
+        //The last stage<> hands its batch to the sink
+        template <size_t STAGE, class RESULT>
+        void forward(RESULT&& batch, std::true_type)
+        {
+          push(results, std::move(batch));
+          std::lock_guard<std::mutex> lock(mutex);
+          ++finished;
+          progress.notify_all();
+        }
+
+        //No queue ever holds more than fMaxInFlight batches, and there's always a batch waiting when a task
+        //pops.  A boundedQueue<> can still report full or empty for a moment while another thread is in the
+        //middle of a push() or pop() on a neighboring cell, so just try again.
+        template <class T>
+        static void push(boundedQueue<T>& queue, T&& batch)
+        {
+          while(!queue.push(std::move(batch))) std::this_thread::yield();
+        }
+
+        template <class T>
+        static void pop(boundedQueue<T>& queue, T& batch)
+        {
+          while(!queue.pop(batch)) std::this_thread::yield();
+        }
+      };
+
+      //Makes sure run() never leaves with the reader still going, even when the sink throws.  Stops the reader,
+      //joins it, then waits for the batches it already read to get through the last stage<> so that no task
+      //calls a stage<> after run() returns.
+      struct readerGuard
+      {
+        readerGuard(std::thread& thread, running& state): reader(thread), shared(state) {}
+
+        ~readerGuard()
+        {
+          {
+            std::lock_guard<std::mutex> lock(shared.mutex);
+            shared.stop = true;
+          }
+          shared.progress.notify_all();
+          reader.join();
+
+          std::unique_lock<std::mutex> lock(shared.mutex);
+          shared.progress.wait(lock, [this] { return shared.finished == shared.produced; });
+        }
+
+        std::thread& reader;
+        running& shared;
+      };
+
+      threadPool& fPool;
+      const size_t fMaxInFlight;
+      std::tuple<STAGES...> fStages;
+  };
+
+  //Deduce STAGES... for a pipeline<>.  Allows up to twice as many batches in flight as there are workers by default.
+  template <class ...STAGES>
+  pipeline<STAGES...> makePipeline(threadPool& pool, STAGES... stages)
+  {
+    return pipeline<STAGES...>(pool, 2 * pool.size(), std::move(stages)...);
+  }
+}
+
+#endif //UNITS_PIPELINE_H
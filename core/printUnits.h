@@ -52,6 +52,14 @@ namespace units
     printProduct<NUM...>(os) << ") / (";
     return printProduct<DENOM...>(os) << ")";
   }
+
+  //Specialization for inverse units, like the elements of a weightMatrix<>
+  template <class ...DENOM, class PREFIX, class FLOATING_POINT>
+  std::ostream& operator <<(std::ostream& os, const quantity<ratioTag<productTag<>, productTag<DENOM...>>, PREFIX, FLOATING_POINT> value)
+  {
+    os << value.template in<quantity<ratioTag<productTag<>, productTag<DENOM...>>, std::ratio<1>, FLOATING_POINT>>() << " 1 / (";
+    return printProduct<DENOM...>(os) << ")";
+  }
 }
 
 #endif //UNITS_PRINTUNITS_H
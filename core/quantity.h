@@ -52,6 +52,37 @@ namespace units
         return value;
       }
     };
+
+    //Comparing lhs in prefix P to rhs in prefix Q is the same as comparing lhs * (P/Q)::num to rhs * (P/Q)::den.
+    //That folds both prefixes into compile-time constants and never divides.
+    template <class LHS_OVER_RHS, class FLOATING_POINT>
+    struct comparison
+    {
+      static inline FLOATING_POINT lhs(const FLOATING_POINT value)
+      {
+        return value * LHS_OVER_RHS::num;
+      }
+
+      static inline FLOATING_POINT rhs(const FLOATING_POINT value)
+      {
+        return value * LHS_OVER_RHS::den;
+      }
+    };
+
+    //Specialization for the same prefix on both sides: No multiplication needed!
+    template <class FLOATING_POINT>
+    struct comparison<std::ratio<1>, FLOATING_POINT>
+    {
+      static inline FLOATING_POINT lhs(const FLOATING_POINT value)
+      {
+        return value;
+      }
+
+      static inline FLOATING_POINT rhs(const FLOATING_POINT value)
+      {
+        return value;
+      }
+    };
   }
   
   //TODO: Compatibility with quantities<> that have FLOATING_POINT types convertible to this one.
@@ -140,29 +171,33 @@ namespace units
         return quantity<typename buildRatio<BASE_TAG, RHS_UNIT>::result, std::ratio_divide<PREFIX, OTHER_PREFIX>, FLOATING_POINT>(fValue / rhs.template in<quantity<RHS_UNIT, OTHER_PREFIX, FLOATING_POINT>>());
       }
   
-      //Comparison operators
+      //Comparison operators.  Prefixes are cross-multiplied instead of converting other.
       template <class OTHER_PREFIX>
       bool operator <(const quantity<BASE_TAG, OTHER_PREFIX, FLOATING_POINT> other) const
       {
-        return fValue < other.template in<quantity<BASE_TAG, PREFIX, FLOATING_POINT>>();
+        using compare = detail::comparison<std::ratio_divide<PREFIX, OTHER_PREFIX>, FLOATING_POINT>;
+        return compare::lhs(fValue) < compare::rhs(other.template in<quantity<BASE_TAG, OTHER_PREFIX, FLOATING_POINT>>());
       }
   
       template <class OTHER_PREFIX>
       bool operator >(const quantity<BASE_TAG, OTHER_PREFIX, FLOATING_POINT> other) const
       {
-        return fValue > other.template in<quantity<BASE_TAG, PREFIX, FLOATING_POINT>>();
+        using compare = detail::comparison<std::ratio_divide<PREFIX, OTHER_PREFIX>, FLOATING_POINT>;
+        return compare::lhs(fValue) > compare::rhs(other.template in<quantity<BASE_TAG, OTHER_PREFIX, FLOATING_POINT>>());
       }
   
       template <class OTHER_PREFIX>
       bool operator ==(const quantity<BASE_TAG, OTHER_PREFIX, FLOATING_POINT> other) const
       {
-        return fValue == other.template in<quantity<BASE_TAG, PREFIX, FLOATING_POINT>>();
+        using compare = detail::comparison<std::ratio_divide<PREFIX, OTHER_PREFIX>, FLOATING_POINT>;
+        return compare::lhs(fValue) == compare::rhs(other.template in<quantity<BASE_TAG, OTHER_PREFIX, FLOATING_POINT>>());
       }
   
       template <class OTHER_PREFIX>
       bool operator !=(const quantity<BASE_TAG, OTHER_PREFIX, FLOATING_POINT> other) const
       {
-        return fValue != other.template in<quantity<BASE_TAG, PREFIX, FLOATING_POINT>>();
+        using compare = detail::comparison<std::ratio_divide<PREFIX, OTHER_PREFIX>, FLOATING_POINT>;
+        return compare::lhs(fValue) != compare::rhs(other.template in<quantity<BASE_TAG, OTHER_PREFIX, FLOATING_POINT>>());
       }
   
     private:
@@ -0,0 +1,156 @@
+//File: threadPool.h
+//Brief: A small work-stealing thread pool.  Each worker keeps its own
+//       deque of tasks and steals from the other workers when it runs
+//       out, so a slow stage doesn't leave the rest of the cores idle.
+//Author: Andrew Olivier aolivier@ur.rochester.edu
+
+//Tasks submitted from inside a worker go onto that worker's own deque.  Workers take their own newest
+//task first, which keeps a batch that was just produced hot in that core's cache, and steal the oldest
+//task from other workers.  Tasks submitted from any other thread are dealt out round-robin.
+//
+//Tasks must not throw.  There's nobody to catch an exception on a worker thread.
+//
+//The destructor finishes every task that has already been submitted before joining the workers.
+
+#ifndef UNITS_THREADPOOL_H
+#define UNITS_THREADPOOL_H
+
+//c++ includes
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace units
+{
+  class threadPool
+  {
+    public:
+      //A threadPool always has at least one worker.  submit() deals tasks out modulo the number of workers.
+      explicit threadPool(size_t nThreads = std::max(1u, std::thread::hardware_concurrency())): fNext(0), fPending(0), fDone(false)
+      {
+        nThreads = std::max<size_t>(nThreads, 1);
+        for(size_t worker = 0; worker < nThreads; ++worker) fWorkers.emplace_back(new queue);
+        for(size_t worker = 0; worker < nThreads; ++worker) fThreads.emplace_back([this, worker] { work(worker); });
+      }
+
+      threadPool(const threadPool&) = delete;
+      threadPool& operator =(const threadPool&) = delete;
+
+      ~threadPool()
+      {
+        {
+          std::lock_guard<std::mutex> lock(fSleepMutex);
+          fDone = true;
+        }
+        fWakeUp.notify_all();
+        for(auto& thread: fThreads) thread.join();
+      }
+
+      size_t size() const { return fWorkers.size(); }
+
+      void submit(std::function<void()> task)
+      {
+        const auto& self = current();
+        const size_t worker = (self.pool == this)?self.index:(fNext++ % fWorkers.size());
+
+        {
+          std::lock_guard<std::mutex> lock(fSleepMutex);
+          ++fPending;
+        }
+
+        {
+          std::lock_guard<std::mutex> lock(fWorkers[worker]->mutex);
+          fWorkers[worker]->tasks.push_back(std::move(task));
+        }
+        fWakeUp.notify_one();
+      }
+
+    private:
+      struct queue
+      {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+      };
+
+      //Which pool and worker the calling thread belongs to, if any
+      struct identity
+      {
+        const threadPool* pool;
+        size_t index;
+      };
+
+      static identity& current()
+      {
+        static thread_local identity self = {nullptr, 0};
+        return self;
+      }
+
+      //Take the newest task from my own deque, then try to steal the oldest task from everyone else.
+      bool take(const size_t worker, std::function<void()>& task)
+      {
+        {
+          std::lock_guard<std::mutex> lock(fWorkers[worker]->mutex);
+          auto& mine = fWorkers[worker]->tasks;
+          if(!mine.empty())
+          {
+            task = std::move(mine.back());
+            mine.pop_back();
+            return true;
+          }
+        }
+
+        for(size_t offset = 1; offset < fWorkers.size(); ++offset)
+        {
+          auto& victim = *fWorkers[(worker + offset) % fWorkers.size()];
+          std::lock_guard<std::mutex> lock(victim.mutex);
+          if(!victim.tasks.empty())
+          {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            return true;
+          }
+        }
+
+        return false;
+      }
+
+      void work(const size_t worker)
+      {
+        current() = identity{this, worker};
+
+        std::function<void()> task;
+        while(true)
+        {
+          if(take(worker, task))
+          {
+            --fPending;
+            task();
+            task = nullptr;
+            continue;
+          }
+
+          std::unique_lock<std::mutex> lock(fSleepMutex);
+          fWakeUp.wait(lock, [this] { return fDone || fPending > 0; });
+          if(fDone && fPending == 0) return;
+        }
+      }
+
+      std::vector<std::unique_ptr<queue>> fWorkers;
+      std::vector<std::thread> fThreads;
+
+      std::atomic<size_t> fNext; //Round-robin counter for tasks from outside the pool
+      std::atomic<size_t> fPending; //Tasks submitted but not yet started
+
+      std::mutex fSleepMutex;
+      std::condition_variable fWakeUp;
+      bool fDone;
+  };
+}
+
+#endif //UNITS_THREADPOOL_H
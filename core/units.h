@@ -58,6 +58,11 @@
 //Declaring your units in a namespace seems to me like a good way to avoid clashes with things like CLHEP.
 //Of course, you can declare your own tags and implicit conversions.  I explain how to do that at the bottom
 //of quantity.h.
+//
+//Batches of quantity<>s with the same units can be stored as a column<>.  See column.h.  pipeline.h builds
+//multithreaded chains of stage<>s that process column<>s, but you have to include it yourself because it
+//needs threads.  covariance.h has covMatrix<>s with mixed units for track fits.  cuts.h selects rows of
+//column<>s into bitmasks.  integrators.h integrates quantity<>s like dE/dx along a path.
 
 #ifndef UNITS_UNITS_H
 #define UNITS_UNITS_H
@@ -68,6 +73,7 @@
 #include "quantity.h"
 #include "printUnits.h"
 #include "macros.h"
+#include "column.h"
 
 //Example snippet of a program using this library:
 //
@@ -0,0 +1,21 @@
+//File: assertCovarianceUnits.cpp
+//Brief: An executable that should NOT compile if covMatrix<> works
+//       as intended.  Only used by built-in test system.
+//Author: Andrew Olivier aolivier@ur.rochester.edu
+
+#include "core/covariance.h"
+
+DECLARE_UNIT(MeV)
+DECLARE_UNIT(cm)
+
+int main(const int /*argc*/, const char** /*argv*/)
+{
+  units::covMatrix<cm, MeV> cov;
+  units::jacobian<std::tuple<MeV, cm>, std::tuple<MeV, cm>> swapped;
+
+  //These lines of code shouldn't compile:
+  cov.set<0, 1>(1_MeV * 1_MeV);
+  const auto propagated = units::similarity(swapped, cov);
+
+  return 0;
+}
@@ -0,0 +1,20 @@
+//File: assertCutUnits.cpp
+//Brief: An executable that should NOT compile if cuts work
+//       as intended.  Only used by built-in test system.
+//Author: Andrew Olivier aolivier@ur.rochester.edu
+
+#include "core/cuts.h"
+
+DECLARE_UNIT(MeV)
+DECLARE_UNIT(cm)
+
+int main(const int /*argc*/, const char** /*argv*/)
+{
+  units::column<cm> distances(10);
+  units::column<MeV> energies(10);
+
+  //This line of code shouldn't compile: field<0>() is a distance
+  const auto passed = (units::field<0>() > 2_MeV).evaluate(std::tie(distances, energies));
+
+  return 0;
+}
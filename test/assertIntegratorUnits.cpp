@@ -0,0 +1,21 @@
+//File: assertIntegratorUnits.cpp
+//Brief: An executable that should NOT compile if integrators work
+//       as intended.  Only used by built-in test system.
+//Author: Andrew Olivier aolivier@ur.rochester.edu
+
+#include "core/integrators.h"
+
+DECLARE_UNIT(MeV)
+DECLARE_UNIT(cm)
+
+int main(const int /*argc*/, const char** /*argv*/)
+{
+  //Forgot to divide by a distance
+  const auto energyLoss = [](const cm /*x*/, const MeV energy) { return MeV(-0.01 * energy.in<MeV>()); };
+
+  //These lines of code shouldn't compile:
+  const MeV energy = units::rk4(energyLoss, 1000_MeV, 0_cm, 100_cm, 1_cm);
+  const MeV adaptive = units::dormandPrince([](const cm, const MeV) { return units::derivativeOf<MeV, cm>(-1.); }, 1000_MeV, 0_cm, 100_cm, 1_cm, 1e-6_cm, 1e-8);
+
+  return 0;
+}
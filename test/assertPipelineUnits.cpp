@@ -0,0 +1,21 @@
+//File: assertPipelineUnits.cpp
+//Brief: An executable that should NOT compile if pipeline<> works
+//       as intended.  Only used by built-in test system.
+//Author: Andrew Olivier aolivier@ur.rochester.edu
+
+#include "core/pipeline.h"
+
+DECLARE_UNIT(MeV)
+DECLARE_UNIT(cm)
+
+int main(const int /*argc*/, const char** /*argv*/)
+{
+  auto energies = units::makeStage<units::column<MeV>, units::column<MeV>>([](units::column<MeV>&& hits) { return std::move(hits); });
+  auto positions = units::makeStage<units::column<cm>, units::column<cm>>([](units::column<cm>&& hits) { return std::move(hits); });
+
+  //This line of code shouldn't compile: positions expects cm, but energies produces MeV
+  units::threadPool pool(1);
+  auto chain = units::makePipeline(pool, energies, positions);
+
+  return 0;
+}
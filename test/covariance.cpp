@@ -0,0 +1,102 @@
+//File: covariance.cpp
+//Brief: Propagate, decompose, and invert covariance matrices with mixed
+//       units, one track at a time and for a column<> of tracks.
+//Author: Andrew Olivier aolivier@ur.rochester.edu
+
+//The library I want to test
+#include "core/covariance.h"
+
+//c++ includes
+#include <iostream>
+#include <cmath>
+
+DECLARE_UNIT(MeV)
+DECLARE_RELATED_UNIT(GeV, MeV, 1000, 1)
+
+DECLARE_UNIT(cm)
+DECLARE_RELATED_UNIT(mm, cm, 1, 10)
+
+//Are two matrices of the same type equal up to rounding?
+template <class MATRIX>
+bool close(const MATRIX& lhs, const MATRIX& rhs)
+{
+  for(size_t element = 0; element < MATRIX::nElements; ++element)
+  {
+    if(std::fabs(*lhs.data(element) - *rhs.data(element)) > 1e-12 * std::fabs(*rhs.data(element))) return false;
+  }
+  return true;
+}
+
+int main(const int /*argc*/, const char** /*argv*/)
+{
+  units::covMatrix<cm, MeV> cov;
+  cov.set<0, 0>(4_cm * 1_cm);
+  cov.set<1, 0>(2_MeV * 1_cm);
+  cov.set<1, 1>(9_MeV * 1_MeV);
+
+  std::cout << "Off-diagonal element in cm MeV: " << cov.get<0, 1>().in<decltype(1_cm * 1_MeV)>() << "\n";
+
+  //Inverse units come out of inverse()
+  const auto weights = units::inverse(cov);
+  std::cout << "Weight for x: " << weights.get<0, 0>() << "\n";
+  std::cout << "Weight for x and E: " << weights.get<0, 1>() << "\n";
+  std::cout << "Weight for E: " << weights.get<1, 1>() << "\n";
+  std::cout << "Inverse of the inverse matches: " << std::boolalpha << close(units::inverse(weights), cov) << "\n";
+
+  //Inverse units with prefixes are printed in base units
+  units::covMatrix<mm, GeV> smallCov;
+  smallCov.set<0, 0>(4_mm * 1_mm);
+  smallCov.set<1, 0>(2_GeV * 1_mm);
+  smallCov.set<1, 1>(9_GeV * 1_GeV);
+  const auto smallWeights = units::inverse(smallCov);
+  std::cout << "Weight for x in mm: " << smallWeights.get<0, 0>() << "\n";
+  std::cout << "Weight for x in mm and E in GeV: " << smallWeights.get<0, 1>() << "\n";
+
+  //Every row of a Cholesky factor has the units of its parameter
+  const auto lower = units::cholesky(cov);
+  std::cout << "Cholesky factor: " << lower.get<0, 0>() << " " << lower.get<1, 0>() << " " << lower.get<1, 1>() << "\n";
+
+  //Change parameters from (cm, MeV) to (mm, GeV).  Prefixes cancel without any conversions.
+  units::jacobian<std::tuple<mm, GeV>, std::tuple<cm, MeV>> jac;
+  jac.set<0, 0>(10_mm / 1_cm);
+  jac.set<1, 1>(0.001_GeV / 1_MeV);
+  const auto rescaled = units::similarity(jac, cov);
+  std::cout << "x variance in mm squared: " << rescaled.get<0, 0>().in<decltype(1_mm * 1_mm)>() << "\n";
+  std::cout << "x variance in cm squared: " << rescaled.get<0, 0>().in<decltype(1_cm * 1_cm)>() << "\n";
+  std::cout << "x and E covariance in cm MeV: " << rescaled.get<0, 1>().in<decltype(1_cm * 1_MeV)>() << "\n";
+  std::cout << "E variance in MeV squared: " << rescaled.get<1, 1>().in<decltype(1_MeV * 1_MeV)>() << "\n";
+
+  //Mix x into E to check the off-diagonal terms
+  jac.set<1, 0>(0.0005_GeV / 1_cm);
+  const auto mixed = units::similarity(jac, cov);
+  std::cout << "Mixed E variance in MeV squared: " << mixed.get<1, 1>().in<decltype(1_MeV * 1_MeV)>() << "\n";
+
+  //Batch versions should give the same answers as one track at a time
+  units::column<units::covMatrix<cm, MeV>> covs;
+  units::column<units::jacobian<std::tuple<mm, GeV>, std::tuple<cm, MeV>>> jacs;
+  for(size_t track = 0; track < 21; ++track)
+  {
+    auto scaled = cov;
+    scaled.set<0, 0>(scaled.get<0, 0>() + decltype(1_cm * 1_cm)(track));
+    scaled.set<1, 1>(scaled.get<1, 1>() + decltype(1_MeV * 1_MeV)(2. * track));
+    covs.push_back(scaled);
+    jacs.push_back(jac);
+  }
+
+  const auto batchWeights = units::inverse(covs);
+  const auto batchLower = units::cholesky(covs);
+  const auto batchMixed = units::similarity(jacs, covs);
+  bool inverseMatches = true, choleskyMatches = true, similarityMatches = true;
+  for(size_t track = 0; track < covs.size(); ++track)
+  {
+    inverseMatches = inverseMatches && close(batchWeights[track], units::inverse(covs[track]));
+    choleskyMatches = choleskyMatches && close(batchLower[track], units::cholesky(covs[track]));
+    similarityMatches = similarityMatches && close(batchMixed[track], units::similarity(jacs[track], covs[track]));
+  }
+  std::cout << "Batch of " << covs.size() << " tracks\n";
+  std::cout << "Batch inverse matches: " << inverseMatches << "\n";
+  std::cout << "Batch Cholesky matches: " << choleskyMatches << "\n";
+  std::cout << "Batch similarity matches: " << similarityMatches << "\n";
+
+  return 0;
+}
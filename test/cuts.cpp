@@ -0,0 +1,86 @@
+//File: cuts.cpp
+//Brief: Select rows of column<>s with cuts and check them against
+//       comparing quantity<>s one at a time.
+//Author: Andrew Olivier aolivier@ur.rochester.edu
+
+//The library I want to test
+#include "core/cuts.h"
+
+//c++ includes
+#include <iostream>
+
+DECLARE_UNIT(MeV)
+DECLARE_RELATED_UNIT(GeV, MeV, 1000, 1)
+
+DECLARE_UNIT(cm)
+DECLARE_RELATED_UNIT(mm, cm, 1, 10)
+
+int main(const int /*argc*/, const char** /*argv*/)
+{
+  //Comparison operators on quantity<>s with different prefixes
+  std::cout << 390_mm << " > " << 30_cm << ": " << std::boolalpha << (390_mm > 30_cm) << "\n";
+  std::cout << 1_GeV << " == " << 1000_MeV << ": " << (1_GeV == 1000_MeV) << "\n";
+
+  //200 rows so that there are full words and a partial word
+  units::column<cm> distances;
+  units::column<MeV> energies;
+  for(size_t row = 0; row < 200; ++row)
+  {
+    distances.push_back(cm(0.5 * row));
+    energies.push_back(MeV(25. * ((row * 7) % 160)));
+  }
+
+  //Rows right at the thresholds, where rounding decides whether they pass
+  distances.push_back(cm(40.1));
+  energies.push_back(MeV(1000));
+  distances.push_back(cm(40.1));
+  energies.push_back(MeV(2000));
+  distances.push_back(cm(50));
+  energies.push_back(MeV(2000));
+  distances.push_back(cm(1.3641));
+  energies.push_back(MeV(1000));
+
+  const auto cut = units::field<0>() > 401_mm && !(units::field<1>() >= 2_GeV);
+  const auto passed = cut.evaluate(std::tie(distances, energies));
+
+  size_t nExpected = 0;
+  bool sameRows = true;
+  for(size_t row = 0; row < distances.size(); ++row)
+  {
+    const bool expected = distances[row] > 401_mm && !(energies[row] > 2_GeV || energies[row] == 2_GeV);
+    nExpected += expected;
+    sameRows = sameRows && (passed.test(row) == expected);
+  }
+
+  std::cout << "Rows: " << passed.size() << "\n";
+  std::cout << "Passed: " << passed.count() << " of " << nExpected << " expected\n";
+  std::cout << "Same rows pass: " << sameRows << "\n";
+
+  //Every comparison has to agree with quantity<> on a threshold that's 1.3641 cm in mm
+  const auto limit = mm(13.641);
+  const auto above = (units::field<0>() > limit).evaluate(std::tie(distances)),
+             below = (units::field<0>() < limit).evaluate(std::tie(distances)),
+             atMost = (units::field<0>() <= limit).evaluate(std::tie(distances)),
+             atLeast = (units::field<0>() >= limit).evaluate(std::tie(distances));
+  bool sameAtBoundary = true;
+  for(size_t row = 0; row < distances.size(); ++row)
+  {
+    sameAtBoundary = sameAtBoundary && (above.test(row) == (distances[row] > limit)) && (below.test(row) == (distances[row] < limit))
+                                    && (atMost.test(row) == !(distances[row] > limit)) && (atLeast.test(row) == !(distances[row] < limit));
+  }
+  std::cout << "Same rows pass at " << limit << ": " << sameAtBoundary << "\n";
+
+  const auto either = (units::field<0>() < 1_cm || units::field<1>() <= 0_GeV).evaluate(std::tie(distances, energies));
+  std::cout << "Passed either cut: " << either.count() << "\n";
+  std::cout << "Passed either or both cuts: " << (passed | either).count() << "\n";
+
+  const auto selected = units::compact(energies, passed);
+  bool sameValues = (selected.size() == passed.count());
+  for(size_t row = 0, out = 0; row < energies.size(); ++row)
+  {
+    if(passed.test(row)) sameValues = sameValues && (selected[out++] == energies[row]);
+  }
+  std::cout << "Compacted " << selected.size() << " energies: " << sameValues << "\n";
+
+  return 0;
+}
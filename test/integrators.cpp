@@ -0,0 +1,94 @@
+//File: integrators.cpp
+//Brief: Check how rk4() and dormandPrince() handle step sizes that don't
+//       divide the path, units with different prefixes, running out of
+//       steps, and integration limits that make no sense.
+//Author: Andrew Olivier aolivier@ur.rochester.edu
+
+//The library I want to test
+#include "core/integrators.h"
+
+//c++ includes
+#include <iostream>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+
+DECLARE_UNIT(MeV)
+DECLARE_RELATED_UNIT(GeV, MeV, 1000, 1)
+
+DECLARE_UNIT(cm)
+DECLARE_RELATED_UNIT(mm, cm, 1, 10)
+
+using dEdx_t = units::derivativeOf<MeV, cm>;
+
+//dE/dx = -k/E, so E(x)^2 = E(0)^2 - 2*k*x
+constexpr double k = 4000; //MeV^2 / cm
+
+MeV exact(const MeV initial, const cm distance)
+{
+  return MeV(std::sqrt(initial.in<MeV>() * initial.in<MeV>() - 2 * k * distance.in<cm>()));
+}
+
+//Which kind of exception, if any, does INTEGRATE throw?  Integrators only explain std::runtime_errors.
+template <class INTEGRATE>
+std::string outcome(const INTEGRATE& integrate)
+{
+  try
+  {
+    integrate();
+  }
+  catch(const std::invalid_argument&)
+  {
+    return "invalid_argument";
+  }
+  catch(const std::runtime_error& e)
+  {
+    return e.what();
+  }
+  return "no exception";
+}
+
+int main(const int /*argc*/, const char** /*argv*/)
+{
+  //RK4 is exact for a constant derivative, so these only depend on where the steps end
+  const auto constantLoss = [](const cm /*x*/, const MeV /*energy*/) { return dEdx_t(-2); };
+  std::cout << "RK4 over 1 cm in steps of at most 0.3 cm: " << units::rk4(constantLoss, 1_GeV, 0_cm, 1_cm, 0.3_cm) << "\n";
+  std::cout << "RK4 over 1 cm with a 5 cm step: " << units::rk4(constantLoss, 1_GeV, 0_cm, 1_cm, 5_cm) << "\n";
+  std::cout << "RK4 over 0 cm: " << units::rk4(constantLoss, 1_GeV, 3_cm, 3_cm, 1_cm) << "\n";
+  std::cout << "Dormand-Prince over 1 cm with a 0.3 cm first step: " << units::dormandPrince(constantLoss, 1_GeV, 0_cm, 1_cm, 0.3_cm, 1e-9_MeV, 1e-12) << "\n";
+
+  //State in GeV, steps in mm, and a derivative in MeV / cm
+  const auto energyLoss = [](const mm /*x*/, const GeV energy) { return dEdx_t(-k / energy.in<MeV>()); };
+  const GeV fixedStep = units::rk4(energyLoss, 1_GeV, 0_cm, 100_cm, 1_mm);
+  const GeV adaptive = units::dormandPrince(energyLoss, 1_GeV, 0_cm, 100_cm, 10_mm, 1e-9_MeV, 1e-12);
+  std::cout << "Exact energy after 100 cm: " << exact(1_GeV, 100_cm) << "\n";
+  std::cout << "RK4 error below 1e-6 MeV: " << std::boolalpha << (std::fabs((fixedStep - exact(1_GeV, 100_cm)).in<MeV>()) < 1e-6) << "\n";
+  std::cout << "Dormand-Prince error below 1e-6 MeV: " << (std::fabs((adaptive - exact(1_GeV, 100_cm)).in<MeV>()) < 1e-6) << "\n";
+
+  //Enough particles for one full block of lanes and a remainder.  Each lane takes its own steps.
+  units::column<GeV> initial;
+  for(size_t particle = 0; particle < units::detail::batchLanes + 3; ++particle) initial.push_back(GeV(0.5 + 0.25 * particle));
+  const auto batchFixed = units::rk4(energyLoss, initial, 0_cm, 25_cm, 1_mm);
+  const auto batchAdaptive = units::dormandPrince(energyLoss, initial, 0_cm, 25_cm, 10_mm, 1e-9_MeV, 1e-12);
+  bool batchAccurate = true;
+  for(size_t particle = 0; particle < initial.size(); ++particle)
+  {
+    batchAccurate = batchAccurate && (std::fabs((batchFixed[particle] - exact(initial[particle], 25_cm)).in<MeV>()) < 1e-6)
+                                  && (std::fabs((batchAdaptive[particle] - exact(initial[particle], 25_cm)).in<MeV>()) < 1e-6);
+  }
+  std::cout << "Batch of " << initial.size() << " particles within 1e-6 MeV: " << batchAccurate << "\n";
+
+  //Running out of steps or tolerance is an error, not an answer
+  std::cout << "Dormand-Prince with 3 steps: " << outcome([&] { units::dormandPrince(energyLoss, 1_GeV, 0_cm, 100_cm, 1_cm, 1e-9_MeV, 1e-12, 3); }) << "\n";
+  std::cout << "Batch Dormand-Prince with 3 steps: " << outcome([&] { units::dormandPrince(energyLoss, initial, 0_cm, 100_cm, 1_cm, 1e-9_MeV, 1e-12, 3); }) << "\n";
+  std::cout << "Dormand-Prince with no tolerance: " << outcome([&] { units::dormandPrince(energyLoss, 1_GeV, 0_cm, 100_cm, 1_cm, 0_MeV, 0); }) << "\n";
+
+  //Limits that make no sense
+  std::cout << "RK4 with a 0 cm step: " << outcome([&] { units::rk4(energyLoss, 1_GeV, 100_cm, 0_cm, 0_cm); }) << "\n";
+  std::cout << "RK4 backwards: " << outcome([&] { units::rk4(energyLoss, 1_GeV, 100_cm, 0_cm, 1_cm); }) << "\n";
+  std::cout << "Batch RK4 with a negative step: " << outcome([&] { units::rk4(energyLoss, initial, 0_cm, 100_cm, -1_cm); }) << "\n";
+  std::cout << "Dormand-Prince with a 0 mm first step: " << outcome([&] { units::dormandPrince(energyLoss, 1_GeV, 0_cm, 100_cm, 0_mm, 1e-9_MeV, 1e-12); }) << "\n";
+  std::cout << "Dormand-Prince backwards: " << outcome([&] { units::dormandPrince(energyLoss, initial, 100_cm, 0_cm, 1_cm, 1e-9_MeV, 1e-12); }) << "\n";
+
+  return 0;
+}
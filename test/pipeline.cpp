@@ -0,0 +1,109 @@
+//File: pipeline.cpp
+//Brief: Run batches of hits through a pipeline<> of unit conversion, calibration,
+//       and analysis stage<>s on several threads.
+//Author: Andrew Olivier aolivier@ur.rochester.edu
+
+//The library I want to test
+#include "core/pipeline.h"
+
+//c++ includes
+#include <iostream>
+#include <stdexcept>
+
+DECLARE_UNIT(MeV)
+DECLARE_RELATED_UNIT(GeV, MeV, 1000, 1)
+
+DECLARE_UNIT(cm)
+
+using dEdx_t = decltype(1_MeV/1_cm);
+
+int main(const int /*argc*/, const char** /*argv*/)
+{
+  constexpr size_t nBatches = 100, hitsPerBatch = 50;
+  const auto padWidth = 2_cm;
+
+  //Pretend to read hit energies in GeV from a file
+  size_t nextBatch = 0;
+  auto source = [&nextBatch](units::column<GeV>& hits)
+  {
+    if(nextBatch == nBatches) return false;
+    for(size_t hit = 0; hit < hitsPerBatch; ++hit) hits.push_back(GeV(0.5*(nextBatch + hit)));
+    ++nextBatch;
+    return true;
+  };
+
+  //The calibration works in MeV.  The pipeline converts GeV to MeV between stages.
+  auto calibrate = units::makeStage<units::column<MeV>, units::column<MeV>>([](units::column<MeV>&& hits)
+  {
+    for(size_t hit = 0; hit < hits.size(); ++hit) hits.set(hit, hits[hit] + hits[hit]);
+    return std::move(hits);
+  });
+
+  auto energyLoss = units::makeStage<units::column<MeV>, units::column<dEdx_t>>([padWidth](units::column<MeV>&& hits)
+  {
+    units::column<dEdx_t> result;
+    result.reserve(hits.size());
+    for(size_t hit = 0; hit < hits.size(); ++hit) result.push_back(hits[hit]/padWidth);
+    return result;
+  });
+
+  //The first stage only declares its output.  column<GeV> converts to column<MeV> automatically.
+  auto unpack = units::makeStage<units::column<GeV>, units::column<GeV>>([](units::column<GeV>&& hits) { return std::move(hits); });
+
+  units::threadPool pool(4);
+  auto chain = units::makePipeline(pool, unpack, calibrate, energyLoss);
+
+  size_t nHits = 0;
+  double sum = 0;
+  const size_t nProcessed = chain.run(source, [&nHits, &sum](units::column<dEdx_t>&& losses)
+  {
+    nHits += losses.size();
+    for(size_t hit = 0; hit < losses.size(); ++hit) sum += losses[hit].in<dEdx_t>();
+  });
+
+  std::cout << "Processed " << nProcessed << " batches\n";
+  std::cout << "Hits: " << nHits << "\n";
+  std::cout << "Sum of dE/dx in MeV per cm: " << static_cast<long long>(sum) << "\n";
+
+  //A sink that throws stops the pipeline.  run() rethrows instead of leaving the reader running.
+  nextBatch = 0;
+  size_t nSeen = 0;
+  try
+  {
+    chain.run(source, [&nSeen](units::column<dEdx_t>&&)
+    {
+      if(++nSeen == 3) throw std::runtime_error("sink failed");
+    });
+    std::cout << "Sink exception: missed\n";
+  }
+  catch(const std::runtime_error& e)
+  {
+    std::cout << "Sink exception: " << e.what() << " after " << nSeen << " batches\n";
+  }
+
+  //So does a source that throws, but only after the batches it already read reach the sink
+  size_t nRead = 0;
+  auto brokenSource = [&nRead](units::column<GeV>& hits)
+  {
+    if(nRead == 10) throw std::runtime_error("source failed");
+    hits.push_back(GeV(1));
+    ++nRead;
+    return true;
+  };
+
+  //A threadPool always has at least one worker
+  units::threadPool single(0);
+  auto serialChain = units::makePipeline(single, unpack, calibrate, energyLoss);
+  nSeen = 0;
+  try
+  {
+    serialChain.run(brokenSource, [&nSeen](units::column<dEdx_t>&&) { ++nSeen; });
+    std::cout << "Source exception: missed\n";
+  }
+  catch(const std::runtime_error& e)
+  {
+    std::cout << "Source exception: " << e.what() << " after " << nSeen << " batches on " << single.size() << " worker\n";
+  }
+
+  return 0;
+}